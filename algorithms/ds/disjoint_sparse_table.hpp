@@ -0,0 +1,94 @@
+
+/**
+ * \brief Defines a class for a Disjoint Sparse Table, for range queries of any associative operation (it doesn't need
+ *        to be idempotent like in SparseTableRMQ, nor commutative).
+ *        At the level h the array is split in blocks of 2^(h + 1) elements, and every position stores the combination
+ *        from it to the middle of its block (suffixes on the left half, prefixes on the right half). A query [l, r] with
+ *        l != r uses the level of the highest bit in which l and r differ, where l and r are on different halves of the
+ *        same block, so the answer is a single combine of two precalculated values.
+ *        State: untested.
+ *        Ref: https://discuss.codechef.com/t/tutorial-disjoint-sparse-table/17404
+ *
+ * \details Build: O(n * log(n)) combines, n * ceil(log2(n)) elements of memory.
+ *          Query: O(1), exactly one combine (none if l == r).
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam CombineFunc Associative function to combine intervals, following the segment trees convention
+ *         (e.g. struct SumCombine { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};).
+ * \tparam DefaultValueFunc Function returning the default value, used when calling with an undefined interval (l > r)
+ *         (e.g. struct SumDefaultValue { ValueType operator()() { return 0; }};).
+ */
+template<typename ValueType, typename CombineFunc, typename DefaultValueFunc>
+class DisjointSparseTable {
+private:
+	int n, levels;
+	std::vector<ValueType> arr;
+	std::vector<ValueType> table; // table[h * n + i]: combination between i and the middle of its block at the level h
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+
+	void calcTable() {
+		levels = 0;
+		while ((1 << levels) < n) levels++;
+		table.resize((size_t)levels * n);
+		for (int h = 0; h < levels; h++) {
+			ValueType* level = table.data() + (size_t)h * n;
+			int half = 1 << h;
+			// Blocks without right half are never used at this level
+			for (int mid = half; mid < n; mid += half * 2) {
+				level[mid - 1] = arr[mid - 1];
+				for (int i = mid - 2; i >= mid - half; i--) level[i] = combine(arr[i], level[i + 1]);
+				level[mid] = arr[mid];
+				for (int i = mid + 1; i < std::min(n, mid + half); i++) level[i] = combine(level[i - 1], arr[i]);
+			}
+		}
+	}
+
+public:
+
+	void build(int size, ValueType* arr) {
+		n = size;
+		this->arr.assign(arr, arr + size);
+		calcTable();
+	}
+
+	void build(const std::vector<ValueType>& arr) {
+		n = (int)arr.size();
+		this->arr = arr;
+		calcTable();
+	}
+
+	ValueType query(int l, int r) {
+		if (l > r) return defaultValueFunc();
+		if (l == r) return arr[l];
+		int h = 31 - __builtin_clz(l ^ r);
+		return combine(table[(size_t)h * n + l], table[(size_t)h * n + r]);
+	}
+};
+
+/** Disjoint sparse table to get sum of values in the given interval */
+template<typename ValueType> struct SumCombineDST { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};
+template<typename ValueType> struct SumDefaultValueDST { ValueType operator()() { return 0; }};
+template<typename ValueType>
+using DisjointSparseTableSum = DisjointSparseTable<ValueType, SumCombineDST<ValueType>, SumDefaultValueDST<ValueType>>;
+
+/** Disjoint sparse table to get product modulo Mod of values in the given interval */
+template<typename ValueType, ValueType Mod> struct ProductModCombineDST {
+	ValueType operator()(ValueType val1, ValueType val2) { return (ValueType)((long long)val1 * val2 % Mod); }
+};
+template<typename ValueType> struct ProductModDefaultValueDST { ValueType operator()() { return 1; }};
+template<typename ValueType, ValueType Mod>
+using DisjointSparseTableProductMod =
+		DisjointSparseTable<ValueType, ProductModCombineDST<ValueType, Mod>, ProductModDefaultValueDST<ValueType>>;
+
+/** Disjoint sparse table to get min value in the given interval */
+template<typename ValueType> struct MinCombineDST { ValueType operator()(ValueType val1, ValueType val2) { return std::min(val1, val2); }};
+template<typename ValueType> struct MinDefaultValueDST { ValueType operator()() { return std::numeric_limits<ValueType>::max(); }};
+template<typename ValueType>
+using DisjointSparseTableMin = DisjointSparseTable<ValueType, MinCombineDST<ValueType>, MinDefaultValueDST<ValueType>>;
+
+/** Disjoint sparse table to get max value in the given interval */
+template<typename ValueType> struct MaxCombineDST { ValueType operator()(ValueType val1, ValueType val2) { return std::max(val1, val2); }};
+template<typename ValueType> struct MaxDefaultValueDST { ValueType operator()() { return std::numeric_limits<ValueType>::min(); }};
+template<typename ValueType>
+using DisjointSparseTableMax = DisjointSparseTable<ValueType, MaxCombineDST<ValueType>, MaxDefaultValueDST<ValueType>>;
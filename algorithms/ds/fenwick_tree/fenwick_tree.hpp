@@ -0,0 +1,158 @@
+
+/**
+ * \brief Defines a class for a Fenwick Tree (Binary Indexed Tree) of any number of dimensions and any commutative
+ *        operation.
+ *        The number of dimensions is a template parameter, and every operation is a loop per dimension nested with
+ *        if constexpr, so an instantiation compiles to the same nested loops as a hand-written 2D or 3D tree. The sizes
+ *        are given at runtime and the tree is a single flat array.
+ *        Prefix queries only need a commutative monoid (e.g. sum, xor, min, max). Box queries subtract two prefixes in
+ *        every dimension, so they also need the inverse of the operation (a group, e.g. sum or xor).
+ *        All the positions are 0-based and the boxes are inclusive, as in the other Fenwick trees.
+ *        State: untested.
+ *        Ref: Competitive Programming 3, section 2.4.4
+ *             https://cp-algorithms.com/data_structures/fenwick.html
+ *
+ * \details Build: O(N * Dims), where N is the product of the sizes.
+ *          Update, prefix query: O(log(n1) * ... * log(nDims))
+ *          Box query: O(2^Dims * log(n1) * ... * log(nDims)), usually less since the two prefixes of a dimension stop
+ *                     when they reach a common index.
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam Dims Number of dimensions.
+ * \tparam CombineFunc Commutative and associative function to combine values
+ *         (e.g. struct SumCombine { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};).
+ * \tparam DefaultValueFunc Function returning the identity of CombineFunc
+ *         (e.g. struct SumDefaultValue { ValueType operator()() { return 0; }};).
+ * \tparam InverseFunc Function returning the inverse of a value, only needed for box queries
+ *         (e.g. struct SumInverse { ValueType operator()(ValueType val) { return -val; }};).
+ */
+template<typename ValueType, int Dims, typename CombineFunc, typename DefaultValueFunc, typename InverseFunc>
+class FenwickTree {
+private:
+	static_assert(Dims >= 1, "FenwickTree requires at least one dimension");
+
+	std::array<int, Dims> sizes;    // size of every dimension plus one (index 0 is not used)
+	std::array<size_t, Dims> steps; // distance in bit between consecutive indexes of every dimension
+	std::vector<ValueType> bit;
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+	InverseFunc inverse;
+
+	template<int D>
+	void update(size_t offset, const std::array<int, Dims>& pos, const ValueType& val) {
+		for (int i = pos[D] + 1; i < sizes[D]; i += i & -i) {
+			if constexpr (D + 1 == Dims) bit[offset + i] = combine(bit[offset + i], val);
+			else update<D + 1>((offset + i) * sizes[D + 1], pos, val);
+		}
+	}
+
+	template<int D>
+	ValueType query(size_t offset, const std::array<int, Dims>& pos) {
+		ValueType res = defaultValueFunc();
+		for (int i = pos[D] + 1; i > 0; i -= i & -i) {
+			if constexpr (D + 1 == Dims) res = combine(res, bit[offset + i]);
+			else res = combine(res, query<D + 1>((offset + i) * sizes[D + 1], pos));
+		}
+		return res;
+	}
+
+	/**
+	 * Box query along the dimension D: prefix(hi + 1) minus prefix(lo). The chain of hi + 1 stops at its first index not
+	 * greater than lo, and the chain of lo reaches exactly that index, so the common rest of both chains cancels out and
+	 * is never visited.
+	 */
+	template<int D>
+	ValueType query(size_t offset, const std::array<int, Dims>& lo, const std::array<int, Dims>& hi) {
+		ValueType res = defaultValueFunc();
+		int i = hi[D] + 1, j = lo[D];
+		for (; i > j; i -= i & -i) {
+			if constexpr (D + 1 == Dims) res = combine(res, bit[offset + i]);
+			else res = combine(res, query<D + 1>((offset + i) * sizes[D + 1], lo, hi));
+		}
+		for (; j > i; j -= j & -j) {
+			if constexpr (D + 1 == Dims) res = combine(res, inverse(bit[offset + j]));
+			else res = combine(res, inverse(query<D + 1>((offset + j) * sizes[D + 1], lo, hi)));
+		}
+		return res;
+	}
+
+public:
+
+	/** Sizes of the dimensions, with all the elements equal to the identity. */
+	void init(const std::array<int, Dims>& dims) {
+		size_t total = 1;
+		for (int d = Dims - 1; d >= 0; d--) {
+			sizes[d] = dims[d] + 1;
+			steps[d] = total;
+			total *= sizes[d];
+		}
+		bit.assign(total, defaultValueFunc());
+	}
+
+	/**
+	 * arr is stored in row-major order (the last dimension is contiguous), as a flat array of dims[0] * ... * dims[Dims-1]
+	 * elements. The tree is built in linear time, running the 1D linear build along every dimension.
+	 */
+	void init(const std::array<int, Dims>& dims, const ValueType* arr) {
+		init(dims);
+		size_t count = 1;
+		for (int d = 0; d < Dims; d++) count *= dims[d];
+		std::array<int, Dims> pos{};
+		for (size_t k = 0; k < count; k++) {
+			size_t offset = 0;
+			for (int d = 0; d < Dims; d++) offset += (pos[d] + 1) * steps[d];
+			bit[offset] = arr[k];
+			for (int d = Dims - 1; d >= 0 && ++pos[d] == dims[d]; d--) pos[d] = 0;
+		}
+		for (int d = 0; d < Dims; d++) {
+			for (size_t offset = 0; offset < bit.size(); offset++) {
+				int i = (int)(offset / steps[d] % sizes[d]);
+				int j = i + (i & -i);
+				if (i > 0 && j < sizes[d]) bit[offset + (j - i) * steps[d]] = combine(bit[offset + (j - i) * steps[d]], bit[offset]);
+			}
+		}
+	}
+
+	/** Combines val into the element at pos (adds it, for a sum). */
+	void update(const std::array<int, Dims>& pos, const ValueType& val) {
+		update<0>(0, pos, val);
+	}
+
+	/** Combination of the elements in the box from the origin to pos (inclusive). */
+	ValueType query(const std::array<int, Dims>& pos) {
+		return query<0>(0, pos);
+	}
+
+	/** Combination of the elements in the box from lo to hi (inclusive). Requires InverseFunc. */
+	ValueType query(const std::array<int, Dims>& lo, const std::array<int, Dims>& hi) {
+		return query<0>(0, lo, hi);
+	}
+};
+
+/** Placeholder InverseFunc for operations without inverse (only prefix queries can be used) */
+struct NoInverseFT {};
+
+/** Fenwick tree to get sum of values in a box */
+template<typename ValueType> struct SumCombineFT { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};
+template<typename ValueType> struct SumDefaultValueFT { ValueType operator()() { return 0; }};
+template<typename ValueType> struct SumInverseFT { ValueType operator()(ValueType val) { return -val; }};
+template<typename ValueType, int Dims = 1>
+using FenwickTreeSum = FenwickTree<ValueType, Dims, SumCombineFT<ValueType>, SumDefaultValueFT<ValueType>, SumInverseFT<ValueType>>;
+
+/** Fenwick tree to get xor of values in a box */
+template<typename ValueType> struct XorCombineFT { ValueType operator()(ValueType val1, ValueType val2) { return val1 ^ val2; }};
+template<typename ValueType> struct XorInverseFT { ValueType operator()(ValueType val) { return val; }};
+template<typename ValueType, int Dims = 1>
+using FenwickTreeXor = FenwickTree<ValueType, Dims, XorCombineFT<ValueType>, SumDefaultValueFT<ValueType>, XorInverseFT<ValueType>>;
+
+/** Fenwick tree to get min value in a prefix box (updates can only decrease the values) */
+template<typename ValueType> struct MinCombineFT { ValueType operator()(ValueType val1, ValueType val2) { return std::min(val1, val2); }};
+template<typename ValueType> struct MinDefaultValueFT { ValueType operator()() { return std::numeric_limits<ValueType>::max(); }};
+template<typename ValueType, int Dims = 1>
+using FenwickTreePrefixMin = FenwickTree<ValueType, Dims, MinCombineFT<ValueType>, MinDefaultValueFT<ValueType>, NoInverseFT>;
+
+/** Fenwick tree to get max value in a prefix box (updates can only increase the values) */
+template<typename ValueType> struct MaxCombineFT { ValueType operator()(ValueType val1, ValueType val2) { return std::max(val1, val2); }};
+template<typename ValueType> struct MaxDefaultValueFT { ValueType operator()() { return std::numeric_limits<ValueType>::lowest(); }};
+template<typename ValueType, int Dims = 1>
+using FenwickTreePrefixMax = FenwickTree<ValueType, Dims, MaxCombineFT<ValueType>, MaxDefaultValueFT<ValueType>, NoInverseFT>;
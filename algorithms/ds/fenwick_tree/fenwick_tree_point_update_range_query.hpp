@@ -1,6 +1,3 @@
-#include <bits/stdc++.h>
-
-using namespace std;
 
 /**
  * \brief Defines a class for a Fenwick Tree (Binary Indexed Tree).
@@ -15,7 +12,7 @@ template<typename ValueType>
 class FenwickTreePointUpdateRangeQuery {
 private:
 	int n{};
-	vector<ValueType> bit;
+	std::vector<ValueType> bit;
 
 	int log2_floor(ValueType i) {
 		return i ? __builtin_clzll(1) - __builtin_clzll(i) : -1;
@@ -34,7 +31,7 @@ public:
 		bit[0] = 0;
 		for (size_t i = 0; i < n; i++) {
 			size_t j = i + (i & -i);
-			if (j <= n) bit[j] += bit[i];
+			if (j < n) bit[j] += bit[i];
 		}
 	}
 
@@ -45,7 +42,7 @@ public:
 		std::copy(arr.begin(), arr.end(), std::next(bit.begin()));
 		for (size_t i = 0; i < n; i++) {
 			size_t j = i + (i & -i);
-			if (j <= n) bit[j] += bit[i];
+			if (j < n) bit[j] += bit[i];
 		}
 	}
 
@@ -77,40 +74,3 @@ public:
 		return pos;
 	}
 };
-
-int main() {
-	int n = 5;
-	FenwickTreePointUpdateRangeQuery<int> bit;
-
-	// print all zeros
-	bit.init(n);
-	for (int i = 0; i < n; i++)
-		cout << bit.sum(i) << " ";
-	cout << endl;
-
-	// print 1 to n
-	bit.init(5, 1);
-	for (int i = 0; i < n; i++)
-		cout << bit.sum(i) << " ";
-	cout << endl;
-
-	// print 1 to n*(n+1)/2
-	vector<int> v = { 1, 2, 3, 4, 5 };
-	bit.init(v);
-	for (int i = 0; i < n; i++)
-		cout << bit.sum(i) << " ";
-	cout << endl;
-
-	// print 1 to n*(n+1)/2
-	bit.init(5);
-	for (int i = 0; i < n; i++) {
-		bit.add(i, i + 1);
-		cout << bit.sum(i) << " ";
-	}
-	cout << endl;
-
-	// print 0 to n-1
-	for (int i = 1; i <= n; i++)
-		cout << bit.searchPos(i) << " ";
-	cout << endl;
-}
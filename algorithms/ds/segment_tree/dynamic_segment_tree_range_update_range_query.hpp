@@ -0,0 +1,214 @@
+
+/**
+ * \brief Defines a class for a Dynamic (sparse) Segment Tree with lazy propagation over a 64-bit key range.
+ *        Nodes are created on demand from a contiguous pool, so memory is proportional to the touched nodes and keys
+ *        do not need to be known (or compressed) in advance. Positions that were never updated hold the default value.
+ *        The value monoid and the update action follow the same functor interface as SegmentTreeRangeUpdateRangeQuery,
+ *        with the length of the intervals given as a long long.
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/segment_tree.html#dynamic-segment-tree
+ *
+ * \details Query: O(log(hi - lo)), it doesn't create nodes.
+ *          Update: O(log(hi - lo)) time. A node that is split creates both of its children, so a point update creates
+ *          at most 2 * ceil(log2(hi - lo + 1)) new nodes, and a range update (up to two split nodes per level, the
+ *          paths of its two ends) at most 4 * ceil(log2(hi - lo + 1)).
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam CombineFunc Function to combine intervals and partial answers
+ *         (e.g. struct SumCombine { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};).
+ * \tparam DefaultValueFunc Function returning the default value, used for untouched positions and undefined intervals
+ *         (e.g. struct SumDefaultValue { ValueType operator()() { return 0; }};).
+ * \tparam LazyType Type of the range updates. A value initialized LazyType() must be the identity update.
+ * \tparam ApplyFunc Function applying an update to the value of an interval of the given length
+ *         (e.g. struct SumAddApply { ValueType operator()(ValueType val, ValueType upd, long long len) { return val + upd * len; }};).
+ *         Applied to the default value it must give the value of an interval of untouched positions after the update.
+ * \tparam ComposeFunc Function returning the update equivalent to applying old and then upd
+ *         (e.g. struct AddCompose { ValueType operator()(ValueType upd, ValueType old) { return upd + old; }};).
+ */
+template<typename ValueType, typename CombineFunc, typename DefaultValueFunc, typename LazyType, typename ApplyFunc, typename ComposeFunc>
+class DynamicSegmentTreeRangeUpdateRangeQuery {
+private:
+	struct Node {
+		ValueType val;
+		LazyType lazy;
+		int left, right; // 0 if the node has no children yet (the root is never a child)
+	};
+
+	long long lo, hi;
+	std::vector<Node> nodes;
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+	ApplyFunc applyFunc;
+	ComposeFunc compose;
+
+	int newNode() {
+		nodes.push_back({ defaultValueFunc(), LazyType(), 0, 0 });
+		return (int)nodes.size() - 1;
+	}
+
+	void apply(int v, long long len, const LazyType& upd) {
+		nodes[v].val = applyFunc(nodes[v].val, upd, len);
+		nodes[v].lazy = compose(upd, nodes[v].lazy);
+	}
+
+	void push(int v, long long tl, long long tr) {
+		if (nodes[v].left == 0) {
+			int left = newNode();
+			int right = newNode();
+			nodes[v].left = left;
+			nodes[v].right = right;
+		}
+		long long tm = tl + (tr - tl) / 2;
+		LazyType upd = nodes[v].lazy;
+		apply(nodes[v].left, tm - tl + 1, upd);
+		apply(nodes[v].right, tr - tm, upd);
+		nodes[v].lazy = LazyType();
+	}
+
+	void pull(int v) {
+		nodes[v].val = combine(nodes[nodes[v].left].val, nodes[nodes[v].right].val);
+	}
+
+	ValueType query(int v, long long tl, long long tr, long long l, long long r) {
+		if (l > r) return defaultValueFunc();
+		if (l == tl && r == tr) return nodes[v].val;
+		// Without children every update covered the whole node, so all of its positions hold the same value
+		if (nodes[v].left == 0) return applyFunc(defaultValueFunc(), nodes[v].lazy, r - l + 1);
+
+		push(v, tl, tr);
+		long long tm = tl + (tr - tl) / 2;
+		return combine(query(nodes[v].left, tl, tm, l, std::min(r, tm)),
+		               query(nodes[v].right, tm + 1, tr, std::max(l, tm + 1), r));
+	}
+
+	void update(int v, long long tl, long long tr, long long pos, ValueType val) {
+		if (tl == tr) {
+			nodes[v].val = val;
+			nodes[v].lazy = LazyType();
+			return;
+		}
+		push(v, tl, tr);
+		long long tm = tl + (tr - tl) / 2;
+		if (pos <= tm) update(nodes[v].left, tl, tm, pos, val);
+		else update(nodes[v].right, tm + 1, tr, pos, val);
+		pull(v);
+	}
+
+	void update(int v, long long tl, long long tr, long long l, long long r, const LazyType& upd) {
+		if (l > r) return;
+		if (l == tl && r == tr) apply(v, tr - tl + 1, upd);
+		else {
+			push(v, tl, tr);
+			long long tm = tl + (tr - tl) / 2;
+			update(nodes[v].left, tl, tm, l, std::min(r, tm), upd);
+			update(nodes[v].right, tm + 1, tr, std::max(l, tm + 1), r, upd);
+			pull(v);
+		}
+	}
+
+public:
+
+	/** Removes every node and sets the key range to [lo, hi] (hi - lo must fit in a long long). */
+	void init(long long lo, long long hi) {
+		this->lo = lo;
+		this->hi = hi;
+		nodes.clear();
+		newNode();
+	}
+
+	/** Reserves the pool for the given amount of nodes, to avoid reallocations. */
+	void reserve(int numNodes) {
+		nodes.reserve(numNodes);
+	}
+
+	int size() {
+		return (int)nodes.size();
+	}
+
+	ValueType query(long long l, long long r) {
+		return query(0, lo, hi, l, r);
+	}
+
+	void update(long long pos, ValueType val) {
+		update(0, lo, hi, pos, val);
+	}
+
+	void update(long long l, long long r, const LazyType& upd) {
+		update(0, lo, hi, l, r, upd);
+	}
+
+	/** Only available if LazyType provides a static add(ValueType) function (e.g. AssignAddLazyDRURQ). */
+	void add(long long l, long long r, ValueType val) {
+		update(0, lo, hi, l, r, LazyType::add(val));
+	}
+};
+
+/**
+ * Range assignment followed by a range addition. Constructing it from a value gives an assignment, so update(l, r, val)
+ * assigns val to the interval and add(l, r, val) adds val to it.
+ */
+template<typename ValueType> struct AssignAddLazyDRURQ {
+	bool assigned;
+	ValueType assignValue, addValue;
+	AssignAddLazyDRURQ() : assigned(false), assignValue(), addValue(0) {}
+	AssignAddLazyDRURQ(ValueType val) : assigned(true), assignValue(val), addValue(0) {}
+	static AssignAddLazyDRURQ add(ValueType val) {
+		AssignAddLazyDRURQ res;
+		res.addValue = val;
+		return res;
+	}
+};
+template<typename ValueType> struct AssignAddComposeDRURQ {
+	AssignAddLazyDRURQ<ValueType> operator()(const AssignAddLazyDRURQ<ValueType>& upd, AssignAddLazyDRURQ<ValueType> old) {
+		if (upd.assigned) return upd;
+		old.addValue += upd.addValue;
+		return old;
+	}
+};
+
+/** Dynamic segment tree with range update range query to get sum of values in the given interval (untouched positions are 0) */
+template<typename ValueType> struct SumDefaultValueDRURQ { ValueType operator()() { return 0; }};
+template<typename ValueType> struct SumCombineDRURQ { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};
+template<typename ValueType> struct SumAssignAddApplyDRURQ {
+	ValueType operator()(ValueType val, const AssignAddLazyDRURQ<ValueType>& upd, long long len) {
+		return (upd.assigned ? upd.assignValue * len : val) + upd.addValue * len;
+	}
+};
+template<typename ValueType>
+using DynamicSegmentTreeRangeUpdateRangeQuerySum =
+		DynamicSegmentTreeRangeUpdateRangeQuery<ValueType, SumCombineDRURQ<ValueType>, SumDefaultValueDRURQ<ValueType>,
+				AssignAddLazyDRURQ<ValueType>, SumAssignAddApplyDRURQ<ValueType>, AssignAddComposeDRURQ<ValueType>>;
+
+/**
+ * Dynamic segment tree with range update range query to get min value in the given interval.
+ * Untouched positions are empty (std::numeric_limits<ValueType>::max()) and stay empty after a range add.
+ */
+template<typename ValueType> struct MinDefaultValueDRURQ { ValueType operator()() { return std::numeric_limits<ValueType>::max(); }};
+template<typename ValueType> struct MinCombineDRURQ { ValueType operator()(ValueType val1, ValueType val2) { return std::min(val1, val2); }};
+template<typename ValueType> struct MinAssignAddApplyDRURQ {
+	ValueType operator()(ValueType val, const AssignAddLazyDRURQ<ValueType>& upd, long long) {
+		if (upd.assigned) return upd.assignValue + upd.addValue;
+		return val == MinDefaultValueDRURQ<ValueType>()() ? val : val + upd.addValue;
+	}
+};
+template<typename ValueType>
+using DynamicSegmentTreeRangeUpdateRangeQueryMin =
+		DynamicSegmentTreeRangeUpdateRangeQuery<ValueType, MinCombineDRURQ<ValueType>, MinDefaultValueDRURQ<ValueType>,
+				AssignAddLazyDRURQ<ValueType>, MinAssignAddApplyDRURQ<ValueType>, AssignAddComposeDRURQ<ValueType>>;
+
+/**
+ * Dynamic segment tree with range update range query to get max value in the given interval.
+ * Untouched positions are empty (std::numeric_limits<ValueType>::min()) and stay empty after a range add.
+ */
+template<typename ValueType> struct MaxDefaultValueDRURQ { ValueType operator()() { return std::numeric_limits<ValueType>::min(); }};
+template<typename ValueType> struct MaxCombineDRURQ { ValueType operator()(ValueType val1, ValueType val2) { return std::max(val1, val2); }};
+template<typename ValueType> struct MaxAssignAddApplyDRURQ {
+	ValueType operator()(ValueType val, const AssignAddLazyDRURQ<ValueType>& upd, long long) {
+		if (upd.assigned) return upd.assignValue + upd.addValue;
+		return val == MaxDefaultValueDRURQ<ValueType>()() ? val : val + upd.addValue;
+	}
+};
+template<typename ValueType>
+using DynamicSegmentTreeRangeUpdateRangeQueryMax =
+		DynamicSegmentTreeRangeUpdateRangeQuery<ValueType, MaxCombineDRURQ<ValueType>, MaxDefaultValueDRURQ<ValueType>,
+				AssignAddLazyDRURQ<ValueType>, MaxAssignAddApplyDRURQ<ValueType>, AssignAddComposeDRURQ<ValueType>>;
@@ -22,12 +22,14 @@ private:
 	DefaultValueFunc defaultValueFunc;
 
 	void build(ValueType arr[], int v, int tl, int tr) {
-		if (tl == tr) st[v] = std::vector<int>(1, arr[tl]);
+		st[v].clear();
+		if (tl == tr) st[v].insert(arr[tl]);
 		else {
 			int tm = (tl + tr) / 2;
 			build(arr, v * 2, tl, tm);
 			build(arr, v * 2 + 1, tm + 1, tr);
-			std::merge(st[v * 2].begin(), st[v * 2].end(), st[v * 2 + 1].begin(), st[v * 2 + 1].end(), back_inserter(st[v]));
+			st[v].insert(st[v * 2].begin(), st[v * 2].end());
+			st[v].insert(st[v * 2 + 1].begin(), st[v * 2 + 1].end());
 		}
 	}
 
@@ -63,6 +65,10 @@ public:
 	ValueType query(int l, int r, ValueType val) {
 		return query(1, 0, n - 1, l, r, val);
 	}
+
+	void update(int idx, ValueType val) {
+		update(1, 0, n - 1, idx, val);
+	}
 };
 
 /** Merge sort segment tree with point update range query to get the smallest number greater or equal to a specified number. */
@@ -81,3 +87,222 @@ template<typename ValueType, int MaxSize>
 using MergeSortSegmentTreePointUpdateRangeQueryMinGreaterEqual =
 		MergeSortSegmentTreePointUpdateRangeQuery<ValueType, MaxSize,
 				MinGreaterEqualCalcResultMSRQ<ValueType>, MinGreaterEqualCombineMSRQ<ValueType>, MinGreaterEqualDefaultValueMSRQ<ValueType>>;
+
+/**
+ * \brief Defines a class for a Merge Sort Segment Tree with point updates that doesn't allocate after the build.
+ *        The layout is the one of MergeSortSegmentTreeFlatRangeQuery: the row k keeps every aligned block
+ *        [i * 2^k, (i + 1) * 2^k) sorted, in a single array. Each sorted block of size s is a tiered vector: chunks of
+ *        O(sqrt(s)) elements stored as circular buffers, ordered between them. Replacing a value removes it (leaving a
+ *        hole) and moves the hole to the position of the new value, shifting elements inside the first and last chunks
+ *        and rotating the chunks in between by one position, so every update has a fixed O(sqrt(n)) worst case cost in
+ *        contiguous memory instead of O(log^2(n)) tree node allocations.
+ *        Only the blocks fully inside [0, n) are kept, as no query uses the others.
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/segment_tree.html#saving-the-entire-subarrays-in-each-vertex
+ *             https://www.ics.uci.edu/~goodrich/pubs/wads99.pdf (tiered vectors)
+ *
+ * \details Build: O(n * log(n))
+ *          Query: O(log(n)) calls to CalcResultFunc (O(log^2(n)) with a binary search).
+ *          Update: O(sqrt(n)) in the worst case.
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam CalcResultFunc Function calculating the answer of a block given a SortedBlock (size(), operator[],
+ *         lowerBound and upperBound) and the value.
+ * \tparam CombineFunc Function to combine partial answers.
+ * \tparam DefaultValueFunc Function returning the default value, used when calling with an undefined interval (l > r).
+ */
+template<typename ValueType, typename CalcResultFunc, typename CombineFunc, typename DefaultValueFunc>
+class MergeSortSegmentTreeTieredPointUpdateRangeQuery {
+public:
+
+	/** Sorted elements of an aligned block, as seen by CalcResultFunc. */
+	class SortedBlock {
+	private:
+		const ValueType* data;
+		const int* heads; // heads[q]: physical position of the first element of the chunk q
+		int sz, chunkLog;
+
+	public:
+
+		SortedBlock(const ValueType* data, const int* heads, int size, int chunkLog)
+				: data(data), heads(heads), sz(size), chunkLog(chunkLog) {}
+
+		int size() const {
+			return sz;
+		}
+
+		ValueType operator[](int j) const {
+			int q = j >> chunkLog;
+			return data[(q << chunkLog) + ((heads[q] + j) & ((1 << chunkLog) - 1))];
+		}
+
+		/** Number of elements less than val. */
+		int lowerBound(ValueType val) const {
+			int lo = 0, hi = sz;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if ((*this)[mid] < val) lo = mid + 1;
+				else hi = mid;
+			}
+			return lo;
+		}
+
+		/** Number of elements less or equal than val. */
+		int upperBound(ValueType val) const {
+			int lo = 0, hi = sz;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (!(val < (*this)[mid])) lo = mid + 1;
+				else hi = mid;
+			}
+			return lo;
+		}
+	};
+
+private:
+	int n, levels;
+	std::vector<ValueType> rows;  // rows[k * n + i]: position i of the row k
+	std::vector<int> heads;       // heads[headOffset[k] + (i >> chunkLog(k))]: head of the chunk containing i in the row k
+	std::vector<int> headOffset;
+	CalcResultFunc calcResultFunc;
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+
+	/** Chunks of about 2 * sqrt(s): shifting inside a chunk is a contiguous copy, cheaper than rotating a chunk. */
+	static int chunkLog(int k) {
+		return std::min(k, (k + 3) / 2);
+	}
+
+	SortedBlock block(int k, int begin) const {
+		int cl = chunkLog(k);
+		return SortedBlock(rows.data() + (size_t)k * n + begin, heads.data() + headOffset[k] + (begin >> cl), 1 << k, cl);
+	}
+
+	/** Rotates the chunk so its elements are in order in memory (head 0), to shift them with a plain copy. */
+	static ValueType* normalize(ValueType* chunk, int& head, int chunkSize) {
+		if (head != 0) {
+			std::rotate(chunk, chunk + head, chunk + chunkSize);
+			head = 0;
+		}
+		return chunk;
+	}
+
+	/** Replaces one occurrence of oldVal with val in the block of the row k starting at begin. */
+	void replace(int k, int begin, ValueType oldVal, ValueType val) {
+		int cl = chunkLog(k), c = 1 << cl, mask = c - 1;
+		ValueType* data = rows.data() + (size_t)k * n + begin;
+		int* hd = heads.data() + headOffset[k] + (begin >> cl);
+		auto at = [&](int j) -> ValueType& { return data[(j & ~mask) + ((hd[j >> cl] + j) & mask)]; };
+
+		SortedBlock sorted(data, hd, 1 << k, cl);
+		int i = sorted.lowerBound(oldVal), j;
+		if (oldVal < val) {
+			// The elements in (i, j] move one position to the left
+			j = sorted.upperBound(val) - 1;
+			int qi = i >> cl, qj = j >> cl;
+			ValueType* first = normalize(data + (qi << cl), hd[qi], c);
+			if (qi == qj) {
+				std::copy(first + (i & mask) + 1, first + (j & mask) + 1, first + (i & mask));
+			} else {
+				std::copy(first + (i & mask) + 1, first + c, first + (i & mask));
+				for (int q = qi + 1; q <= qj; q++) {
+					at((q << cl) - 1) = at(q << cl);
+					hd[q] = (hd[q] + 1) & mask; // The hole is now the last element of the chunk q
+				}
+				ValueType* last = normalize(data + (qj << cl), hd[qj], c);
+				std::copy_backward(last + (j & mask), last + c - 1, last + c);
+			}
+		} else {
+			// The elements in [j, i) move one position to the right
+			j = sorted.lowerBound(val);
+			int qi = i >> cl, qj = j >> cl;
+			ValueType* first = normalize(data + (qi << cl), hd[qi], c);
+			if (qi == qj) {
+				std::copy_backward(first + (j & mask), first + (i & mask), first + (i & mask) + 1);
+			} else {
+				std::copy_backward(first, first + (i & mask), first + (i & mask) + 1);
+				for (int q = qi - 1; q >= qj; q--) {
+					at((q + 1) << cl) = at(((q + 1) << cl) - 1);
+					hd[q] = (hd[q] - 1) & mask; // The hole is now the first element of the chunk q
+				}
+				ValueType* last = normalize(data + (qj << cl), hd[qj], c);
+				std::copy(last + 1, last + (j & mask) + 1, last);
+			}
+		}
+		at(j) = val;
+	}
+
+public:
+
+	void build(int size, ValueType* arr) {
+		n = size;
+		levels = 1;
+		while ((2 << (levels - 1)) <= n) levels++;
+		rows.resize((size_t)levels * n);
+		headOffset.assign(levels, 0);
+		int totalHeads = 0;
+		for (int k = 0; k < levels; k++) {
+			headOffset[k] = totalHeads;
+			totalHeads += (n >> chunkLog(k)) + 1;
+		}
+		heads.assign(totalHeads, 0);
+		std::copy(arr, arr + n, rows.begin());
+		for (int k = 0; k + 1 < levels; k++) {
+			const ValueType* src = rows.data() + (size_t)k * n;
+			ValueType* dst = rows.data() + (size_t)(k + 1) * n;
+			for (int i = 0; i + (2 << k) <= n; i += 2 << k)
+				std::merge(src + i, src + i + (1 << k), src + i + (1 << k), src + i + (2 << k), dst + i);
+		}
+	}
+
+	ValueType query(int l, int r, ValueType val) {
+		ValueType resL = defaultValueFunc(), resR = defaultValueFunc();
+		// l and r + 1 are multiples of 2^k at the level k, a bit set on them means an aligned block to take
+		for (int k = 0, end = r + 1; l < end; k++) {
+			if (l & (1 << k)) {
+				resL = combine(resL, calcResultFunc(block(k, l), val));
+				l += 1 << k;
+			}
+			if (end & (1 << k)) {
+				end -= 1 << k;
+				resR = combine(calcResultFunc(block(k, end), val), resR);
+			}
+		}
+		return combine(resL, resR);
+	}
+
+	void update(int idx, ValueType val) {
+		ValueType oldVal = rows[idx];
+		if (!(oldVal < val) && !(val < oldVal)) return;
+		for (int k = 0; k < levels && ((idx >> k) + 1) << k <= n; k++)
+			replace(k, (idx >> k) << k, oldVal, val);
+	}
+};
+
+/** Tiered merge sort segment tree with point update range query to get the smallest number greater or equal to a specified number. */
+template<typename ValueType> struct MinGreaterEqualCalcResultTieredMSRQ {
+	template<typename SortedBlock>
+	ValueType operator()(const SortedBlock& sortedBlock, ValueType val) {
+		int pos = sortedBlock.lowerBound(val);
+		if (pos < sortedBlock.size()) return sortedBlock[pos];
+		return MinGreaterEqualDefaultValueMSRQ<ValueType>()();
+	}
+};
+template<typename ValueType>
+using MergeSortSegmentTreeTieredPointUpdateRangeQueryMinGreaterEqual =
+		MergeSortSegmentTreeTieredPointUpdateRangeQuery<ValueType,
+				MinGreaterEqualCalcResultTieredMSRQ<ValueType>, MinGreaterEqualCombineMSRQ<ValueType>, MinGreaterEqualDefaultValueMSRQ<ValueType>>;
+
+/** Tiered merge sort segment tree with point update range query to get the number of elements greater than a specified number. */
+template<typename ValueType> struct SumGreaterCombineTieredMSRQ { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};
+template<typename ValueType> struct SumGreaterDefaultValueTieredMSRQ { ValueType operator()() { return 0; }};
+template<typename ValueType> struct SumGreaterCalcResultTieredMSRQ {
+	template<typename SortedBlock>
+	ValueType operator()(const SortedBlock& sortedBlock, ValueType val) {
+		return sortedBlock.size() - sortedBlock.upperBound(val);
+	}
+};
+template<typename ValueType>
+using MergeSortSegmentTreeTieredPointUpdateRangeQuerySumGreater =
+		MergeSortSegmentTreeTieredPointUpdateRangeQuery<ValueType,
+				SumGreaterCalcResultTieredMSRQ<ValueType>, SumGreaterCombineTieredMSRQ<ValueType>, SumGreaterDefaultValueTieredMSRQ<ValueType>>;
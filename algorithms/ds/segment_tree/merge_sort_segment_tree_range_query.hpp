@@ -1,4 +1,36 @@
 
+/**
+ * \brief Merges the sorted ranges [a, a + na) and [b, b + nb) into out with the same result as std::merge, splitting the
+ *        output into equal parts merged by different threads. The split points come from a binary search over the
+ *        merge path (the diagonal d of the output takes i elements of a and d - i of b).
+ *        Ref: https://en.wikipedia.org/wiki/Merge_algorithm#Parallel_merge
+ */
+template<typename ValueType>
+void parallelMerge(const ValueType* a, int na, const ValueType* b, int nb, ValueType* out, int threads) {
+	if (threads <= 1) {
+		std::merge(a, a + na, b, b + nb, out);
+		return;
+	}
+	auto split = [&](int d) { // Elements of a among the first d elements of the output
+		int lo = std::max(0, d - nb), hi = std::min(d, na);
+		while (lo < hi) {
+			int i = (lo + hi) / 2;
+			if (b[d - i - 1] < a[i]) hi = i;
+			else lo = i + 1;
+		}
+		return lo;
+	};
+	std::vector<std::future<void>> parts;
+	for (int t = 0; t < threads; t++) {
+		int d1 = (int)((long long)(na + nb) * t / threads), d2 = (int)((long long)(na + nb) * (t + 1) / threads);
+		int i1 = split(d1), i2 = split(d2);
+		parts.push_back(std::async(std::launch::async, [=]() {
+			std::merge(a + i1, a + i2, b + d1 - i1, b + d2 - i2, out + d1);
+		}));
+	}
+	for (auto& part : parts) part.get();
+}
+
 /**
  * \brief Defines a class for a Segment Tree.
  *        State: untested.
@@ -14,6 +46,8 @@
 template<typename ValueType, int MaxSize, typename CalcResultFunc, typename CombineFunc, typename DefaultValueFunc>
 class MergeSortSegmentTreeRangeQuery {
 private:
+	static constexpr int ParallelMinSize = 1 << 15; // smaller subtrees are built by a single thread
+
 	int n;
 	std::vector<ValueType> st[MaxSize * 4];
 	CalcResultFunc calcResultFunc;
@@ -21,7 +55,8 @@ private:
 	DefaultValueFunc defaultValueFunc;
 
 	void build(ValueType arr[], int v, int tl, int tr) {
-		if (tl == tr) st[v] = std::vector<int>(1, arr[tl]);
+		st[v].clear();
+		if (tl == tr) st[v].push_back(arr[tl]);
 		else {
 			int tm = (tl + tr) / 2;
 			build(arr, v * 2, tl, tm);
@@ -30,6 +65,20 @@ private:
 		}
 	}
 
+	/** Builds the children in parallel, splitting the threads between them, and merges them with all the threads. */
+	void build(ValueType arr[], int v, int tl, int tr, int threads) {
+		if (threads <= 1 || tr - tl < ParallelMinSize) {
+			build(arr, v, tl, tr);
+			return;
+		}
+		int tm = (tl + tr) / 2;
+		auto left = std::async(std::launch::async, [&]() { build(arr, v * 2, tl, tm, threads / 2); });
+		build(arr, v * 2 + 1, tm + 1, tr, threads - threads / 2);
+		left.get();
+		st[v].resize(tr - tl + 1);
+		parallelMerge(st[v * 2].data(), (int)st[v * 2].size(), st[v * 2 + 1].data(), (int)st[v * 2 + 1].size(), st[v].data(), threads);
+	}
+
 	ValueType query(int v, int tl, int tr, int l, int r, ValueType val) {
 		if (l > r) return defaultValueFunc();
 		if (l == tl && r == tr) return calcResultFunc(st[v], val);
@@ -46,6 +95,12 @@ public:
 		build(arr, 1, 0, size - 1);
 	}
 
+	/** Same as build(size, arr) using up to the given number of threads (e.g. std::thread::hardware_concurrency()). */
+	void build(int size, ValueType* arr, int threads) {
+		n = size;
+		build(arr, 1, 0, size - 1, threads);
+	}
+
 	ValueType query(int l, int r, ValueType val) {
 		return query(1, 0, n - 1, l, r, val);
 	}
@@ -80,3 +135,275 @@ template<typename ValueType, int MaxSize>
 using MergeSortSegmentTreeRangeQuerySumGreater =
 		MergeSortSegmentTreeRangeQuery<ValueType, MaxSize,
 				SumGreaterCalcResultMSRQ<ValueType>, SumGreaterCombineMSRQ<ValueType>, SumGreaterDefaultValueMSRQ<ValueType>>;
+
+/**
+ * \brief Defines a class for a Merge Sort Segment Tree stored in a single contiguous array.
+ *        The row k holds the array with every aligned block [i * 2^k, (i + 1) * 2^k) sorted, so the rows are built level
+ *        by level (row k + 1 merges pairs of adjacent blocks of row k) and a query decomposes [l, r] bottom-up into
+ *        O(log(n)) aligned blocks. It uses n * (floor(log2(n)) + 1) elements and a single allocation, instead of one
+ *        vector (and its header) per node.
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/segment_tree.html#saving-the-entire-subarrays-in-each-vertex
+ *
+ * \details Build: O(n * log(n))
+ *          Query: O(log(n)) calls to CalcResultFunc (O(log^2(n)) with a binary search).
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam CalcResultFunc Function calculating the answer of a block given its sorted elements [begin, end) and the value.
+ * \tparam CombineFunc Function to combine partial answers.
+ * \tparam DefaultValueFunc Function returning the default value, used when calling with an undefined interval (l > r).
+ */
+template<typename ValueType, typename CalcResultFunc, typename CombineFunc, typename DefaultValueFunc>
+class MergeSortSegmentTreeFlatRangeQuery {
+private:
+	int n, levels;
+	std::vector<ValueType> rows; // rows[k * n + i]: position i of the row k
+	CalcResultFunc calcResultFunc;
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+
+	/** Merges the pairs of blocks of the row k starting in [from, to) into the row k + 1. */
+	void buildBlocks(int k, int from, int to) {
+		const ValueType* src = rows.data() + (size_t)k * n;
+		ValueType* dst = rows.data() + (size_t)(k + 1) * n;
+		for (int i = from; i < to; i += 2 << k) {
+			int mid = std::min(n, i + (1 << k)), end = std::min(n, i + (2 << k));
+			std::merge(src + i, src + mid, src + mid, src + end, dst + i);
+		}
+	}
+
+public:
+
+	void build(int size, ValueType* arr) {
+		build(size, arr, 1);
+	}
+
+	/**
+	 * Same as build(size, arr) using up to the given number of threads (e.g. std::thread::hardware_concurrency()).
+	 * Each level is split into groups of blocks, one per thread, while there are enough blocks. The upper levels merge
+	 * each pair of blocks with all the threads (parallelMerge).
+	 */
+	void build(int size, ValueType* arr, int threads) {
+		n = size;
+		levels = 1;
+		while ((2 << (levels - 1)) <= n) levels++;
+		rows.resize((size_t)levels * n);
+		std::copy(arr, arr + n, rows.begin());
+		for (int k = 0; k + 1 < levels; k++) {
+			int blocks = (n + (2 << k) - 1) / (2 << k);
+			if (threads <= 1) buildBlocks(k, 0, n);
+			else if (blocks >= threads) {
+				std::vector<std::future<void>> groups;
+				for (int t = 0; t < threads; t++) {
+					int from = (int)((long long)blocks * t / threads) << (k + 1);
+					int to = std::min(n, (int)((long long)blocks * (t + 1) / threads) << (k + 1));
+					groups.push_back(std::async(std::launch::async, [=]() { buildBlocks(k, from, to); }));
+				}
+				for (auto& group : groups) group.get();
+			} else {
+				const ValueType* src = rows.data() + (size_t)k * n;
+				ValueType* dst = rows.data() + (size_t)(k + 1) * n;
+				for (int i = 0; i < n; i += 2 << k) {
+					int mid = std::min(n, i + (1 << k)), end = std::min(n, i + (2 << k));
+					parallelMerge(src + i, mid - i, src + mid, end - mid, dst + i, threads);
+				}
+			}
+		}
+	}
+
+	ValueType query(int l, int r, ValueType val) {
+		ValueType resL = defaultValueFunc(), resR = defaultValueFunc();
+		const ValueType* row = rows.data();
+		// l and r + 1 are multiples of 2^k at the level k, a bit set on them means an aligned block to take
+		for (int size = 1, end = r + 1; l < end; size <<= 1, row += n) {
+			if (l & size) {
+				resL = combine(resL, calcResultFunc(row + l, row + l + size, val));
+				l += size;
+			}
+			if (end & size) {
+				end -= size;
+				resR = combine(calcResultFunc(row + end, row + end + size, val), resR);
+			}
+		}
+		return combine(resL, resR);
+	}
+};
+
+/** Flat merge sort segment tree with range query to get the smallest number greater or equal to a specified number. */
+template<typename ValueType> struct MinGreaterEqualCalcResultFlatMSRQ {
+	ValueType operator()(const ValueType* begin, const ValueType* end, ValueType val) {
+		const ValueType* pos = std::lower_bound(begin, end, val);
+		if (pos != end) return *pos;
+		return MinGreaterEqualDefaultValueMSRQ<ValueType>()();
+	}
+};
+template<typename ValueType>
+using MergeSortSegmentTreeFlatRangeQueryMinGreaterEqual =
+		MergeSortSegmentTreeFlatRangeQuery<ValueType,
+				MinGreaterEqualCalcResultFlatMSRQ<ValueType>, MinGreaterEqualCombineMSRQ<ValueType>, MinGreaterEqualDefaultValueMSRQ<ValueType>>;
+
+/** Flat merge sort segment tree with range query to get the number of elements greater than a specified number. */
+template<typename ValueType> struct SumGreaterCalcResultFlatMSRQ {
+	ValueType operator()(const ValueType* begin, const ValueType* end, ValueType val) {
+		return std::distance(std::upper_bound(begin, end, val), end);
+	}
+};
+template<typename ValueType>
+using MergeSortSegmentTreeFlatRangeQuerySumGreater =
+		MergeSortSegmentTreeFlatRangeQuery<ValueType,
+				SumGreaterCalcResultFlatMSRQ<ValueType>, SumGreaterCombineMSRQ<ValueType>, SumGreaterDefaultValueMSRQ<ValueType>>;
+
+/**
+ * \brief Defines a class for a Merge Sort Segment Tree with fractional cascading.
+ *        Besides its sorted segment, every node stores bridges: how many of its first i elements come from the left
+ *        child. Any position found at the root with a single binary search (e.g. the lower bound of a value) is a
+ *        prefix of the sorted order, so it is translated to both children with one lookup instead of a new search.
+ *        The sorted segments and the bridges of each level are stored in one row of n elements (the node [tl, tr] uses
+ *        the positions tl..tr), so following a bridge is a single dependent load, and the queries walk the paths of both
+ *        ends of the interval together so the loads of the two paths overlap.
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/segment_tree.html#saving-the-entire-subarrays-in-each-vertex
+ *             https://en.wikipedia.org/wiki/Fractional_cascading
+ *
+ * \details Build: O(n * log(n))
+ *          Query: O(log(n)), one binary search plus O(log(n)) bridge lookups.
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam SearchFunc Function returning the position of the value in the sorted segment [begin, end) of the root, which
+ *         must be the size of a prefix closed under the order (e.g. std::lower_bound or std::upper_bound).
+ * \tparam CalcResultFunc Function calculating the answer of a whole node given its sorted segment [begin, end) and the
+ *         position.
+ * \tparam CombineFunc Function to combine partial answers.
+ * \tparam DefaultValueFunc Function returning the default value, used when calling with an undefined interval (l > r).
+ */
+template<typename ValueType, typename SearchFunc, typename CalcResultFunc, typename CombineFunc, typename DefaultValueFunc>
+class MergeSortSegmentTreeFractionalCascadingRangeQuery {
+private:
+	int n;
+	std::vector<ValueType> sorted; // sorted[d * n + tl..tr]: sorted segment of the node [tl, tr] at depth d
+	std::vector<int> bridge;       // bridge[d * n + tl + i - 1]: elements from the left child among the first i (1 <= i)
+	SearchFunc searchFunc;
+	CalcResultFunc calcResultFunc;
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+
+	void build(ValueType arr[], int depth, int tl, int tr) {
+		ValueType* dst = sorted.data() + (size_t)depth * n;
+		if (tl == tr) {
+			dst[tl] = arr[tl];
+			return;
+		}
+		int tm = (tl + tr) / 2;
+		build(arr, depth + 1, tl, tm);
+		build(arr, depth + 1, tm + 1, tr);
+		const ValueType* src = sorted.data() + (size_t)(depth + 1) * n;
+		int* brg = bridge.data() + (size_t)depth * n;
+		int i = tl, j = tm + 1;
+		for (int k = tl; k <= tr; k++) {
+			// Stable merge, taking the left element on ties
+			if (j > tr || (i <= tm && !(src[j] < src[i]))) dst[k] = src[i++];
+			else dst[k] = src[j++];
+			brg[k] = i - tl;
+		}
+	}
+
+	/** Position in the left child of the node [tl, tr] at the given depth, for a position pos of the node. */
+	int leftPosition(int depth, int tl, int pos) {
+		return pos == 0 ? 0 : bridge[(size_t)depth * n + tl + pos - 1];
+	}
+
+	ValueType calcResult(int depth, int tl, int tr, int pos) {
+		const ValueType* segment = sorted.data() + (size_t)depth * n + tl;
+		return calcResultFunc(segment, segment + (tr - tl + 1), pos);
+	}
+
+public:
+
+	void build(int size, ValueType* arr) {
+		n = size;
+		int levels = 1;
+		while ((1 << (levels - 1)) < size) levels++;
+		sorted.assign((size_t)levels * n, ValueType());
+		bridge.assign((size_t)levels * n, 0);
+		build(arr, 0, 0, size - 1);
+	}
+
+	ValueType query(int l, int r, ValueType val) {
+		if (l > r) return defaultValueFunc();
+		int depth = 0, tl = 0, tr = n - 1, tm = 0, leftPos = 0;
+		int pos = searchFunc(sorted.data(), sorted.data() + n, val);
+		// Common path, until l and r fall into different children
+		while (l != tl || r != tr) {
+			tm = (tl + tr) / 2;
+			leftPos = leftPosition(depth, tl, pos);
+			if (l > tm) tl = tm + 1, pos -= leftPos;
+			else if (r <= tm) tr = tm, pos = leftPos;
+			else break;
+			depth++;
+		}
+		if (l == tl && r == tr) return calcResult(depth, tl, tr, pos);
+
+		// Then the paths of l and r are walked together, so their bridge lookups (dependent loads) overlap
+		int la = tl, lb = tm, lpos = leftPos, ra = tm + 1, rb = tr, rpos = pos - leftPos;
+		ValueType resL = defaultValueFunc(), resR = defaultValueFunc();
+		bool leftDone = false, rightDone = false;
+		for (depth++; !leftDone || !rightDone; depth++) {
+			if (!leftDone) {
+				if (l == la) {
+					resL = combine(calcResult(depth, la, lb, lpos), resL);
+					leftDone = true;
+				} else {
+					int m = (la + lb) / 2, childPos = leftPosition(depth, la, lpos);
+					if (l <= m) {
+						resL = combine(calcResult(depth + 1, m + 1, lb, lpos - childPos), resL);
+						lb = m, lpos = childPos;
+					} else la = m + 1, lpos -= childPos;
+				}
+			}
+			if (!rightDone) {
+				if (r == rb) {
+					resR = combine(resR, calcResult(depth, ra, rb, rpos));
+					rightDone = true;
+				} else {
+					int m = (ra + rb) / 2, childPos = leftPosition(depth, ra, rpos);
+					if (r > m) {
+						resR = combine(resR, calcResult(depth + 1, ra, m, childPos));
+						ra = m + 1, rpos -= childPos;
+					} else rb = m, rpos = childPos;
+				}
+			}
+		}
+		return combine(resL, resR);
+	}
+};
+
+/** Fractional cascading merge sort segment tree with range query to get the smallest number greater or equal to a specified number. */
+template<typename ValueType> struct MinGreaterEqualSearchFCMSRQ {
+	int operator()(const ValueType* begin, const ValueType* end, ValueType val) {
+		return std::distance(begin, std::lower_bound(begin, end, val));
+	}
+};
+template<typename ValueType> struct MinGreaterEqualCalcResultFCMSRQ {
+	ValueType operator()(const ValueType* begin, const ValueType* end, int pos) {
+		if (pos < end - begin) return begin[pos];
+		return MinGreaterEqualDefaultValueMSRQ<ValueType>()();
+	}
+};
+template<typename ValueType>
+using MergeSortSegmentTreeFractionalCascadingRangeQueryMinGreaterEqual =
+		MergeSortSegmentTreeFractionalCascadingRangeQuery<ValueType, MinGreaterEqualSearchFCMSRQ<ValueType>,
+				MinGreaterEqualCalcResultFCMSRQ<ValueType>, MinGreaterEqualCombineMSRQ<ValueType>, MinGreaterEqualDefaultValueMSRQ<ValueType>>;
+
+/** Fractional cascading merge sort segment tree with range query to get the number of elements greater than a specified number. */
+template<typename ValueType> struct SumGreaterSearchFCMSRQ {
+	int operator()(const ValueType* begin, const ValueType* end, ValueType val) {
+		return std::distance(begin, std::upper_bound(begin, end, val));
+	}
+};
+template<typename ValueType> struct SumGreaterCalcResultFCMSRQ {
+	ValueType operator()(const ValueType* begin, const ValueType* end, int pos) { return (int)(end - begin) - pos; }
+};
+template<typename ValueType>
+using MergeSortSegmentTreeFractionalCascadingRangeQuerySumGreater =
+		MergeSortSegmentTreeFractionalCascadingRangeQuery<ValueType, SumGreaterSearchFCMSRQ<ValueType>,
+				SumGreaterCalcResultFCMSRQ<ValueType>, SumGreaterCombineMSRQ<ValueType>, SumGreaterDefaultValueMSRQ<ValueType>>;
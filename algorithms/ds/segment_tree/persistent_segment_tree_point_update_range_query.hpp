@@ -0,0 +1,178 @@
+
+/**
+ * \brief Defines a class for a Persistent Segment Tree (path copying).
+ *        Every update creates O(log(n)) new nodes and a new version, older versions remain unchanged and can be queried.
+ *        Nodes live in a contiguous arena and reference their children by index.
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/segment_tree.html#preserving-the-history-of-its-values-persistent-segment-tree
+ *
+ * \details Build: O(n)
+ *          Query: O(log(n))
+ *          Update: O(log(n)) time and memory
+ *          K-th: O(log(n))
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam CombineFunc Function to combine intervals and partial answers
+ *         (e.g. struct SumCombine { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};).
+ * \tparam DefaultValueFunc Function returning the default value, used when calling with an undefined interval (l > r)
+ *         (e.g. struct SumDefaultValue { ValueType operator()() { return 0; }};).
+ */
+template<typename ValueType, typename CombineFunc, typename DefaultValueFunc>
+class PersistentSegmentTreePointUpdateRangeQuery {
+private:
+	struct Node {
+		ValueType val;
+		int left, right;
+	};
+
+	int n;
+	std::vector<Node> nodes;
+	std::vector<int> roots;
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+
+	int newNode(ValueType val, int left, int right) {
+		nodes.push_back({ val, left, right });
+		return (int)nodes.size() - 1;
+	}
+
+	int newNode(int left, int right) {
+		return newNode(combine(nodes[left].val, nodes[right].val), left, right);
+	}
+
+	int build(int tl, int tr, ValueType val) {
+		if (tl == tr) return newNode(val, -1, -1);
+		int tm = (tl + tr) / 2;
+		int left = build(tl, tm, val);
+		int right = build(tm + 1, tr, val);
+		return newNode(left, right);
+	}
+
+	int build(ValueType arr[], int tl, int tr) {
+		if (tl == tr) return newNode(arr[tl], -1, -1);
+		int tm = (tl + tr) / 2;
+		int left = build(arr, tl, tm);
+		int right = build(arr, tm + 1, tr);
+		return newNode(left, right);
+	}
+
+	ValueType query(int v, int tl, int tr, int l, int r) {
+		if (l > r) return defaultValueFunc();
+		if (l == tl && r == tr) return nodes[v].val;
+
+		int tm = (tl + tr) / 2;
+		return combine(query(nodes[v].left, tl, tm, l, std::min(r, tm)),
+		               query(nodes[v].right, tm + 1, tr, std::max(l, tm + 1), r));
+	}
+
+	int update(int v, int tl, int tr, int pos, ValueType val, bool accumulate) {
+		if (tl == tr) return newNode(accumulate ? combine(nodes[v].val, val) : val, -1, -1);
+		int tm = (tl + tr) / 2;
+		int left = nodes[v].left, right = nodes[v].right;
+		if (pos <= tm) left = update(left, tl, tm, pos, val, accumulate);
+		else right = update(right, tm + 1, tr, pos, val, accumulate);
+		return newNode(left, right);
+	}
+
+	int kth(int vl, int vr, int tl, int tr, ValueType k) {
+		while (tl != tr) {
+			int tm = (tl + tr) / 2;
+			ValueType leftCount = nodes[nodes[vr].left].val - nodes[nodes[vl].left].val;
+			if (k <= leftCount) {
+				vl = nodes[vl].left;
+				vr = nodes[vr].left;
+				tr = tm;
+			} else {
+				k -= leftCount;
+				vl = nodes[vl].right;
+				vr = nodes[vr].right;
+				tl = tm + 1;
+			}
+		}
+		return tl;
+	}
+
+	int addVersion(int root) {
+		roots.push_back(root);
+		return (int)roots.size() - 1;
+	}
+
+	void clear(int size) {
+		n = size;
+		nodes.clear();
+		roots.clear();
+	}
+
+public:
+
+	/** Reserves the arena for the initial version plus the given amount of updates, to avoid reallocations. */
+	void reserve(int size, int updates) {
+		int lg = 1;
+		while ((1 << (lg - 1)) < size) lg++;
+		nodes.reserve(2 * (size_t)size + (size_t)updates * (lg + 1));
+		roots.reserve(updates + 1);
+	}
+
+	/** All the build functions remove every existing version and return the id of the initial one (0). */
+	int build(int size) {
+		return build(size, defaultValueFunc());
+	}
+
+	int build(int size, ValueType val) {
+		clear(size);
+		return addVersion(build(0, size - 1, val));
+	}
+
+	int build(int size, ValueType* arr) {
+		clear(size);
+		return addVersion(build(arr, 0, size - 1));
+	}
+
+	int versions() {
+		return (int)roots.size();
+	}
+
+	ValueType query(int version, int l, int r) {
+		return query(roots[version], 0, n - 1, l, r);
+	}
+
+	/** Creates a new version from the given one with arr[idx] = val and returns its id. */
+	int update(int version, int idx, ValueType val) {
+		return addVersion(update(roots[version], 0, n - 1, idx, val, false));
+	}
+
+	/** Creates a new version from the given one with arr[idx] = combine(arr[idx], val) and returns its id. */
+	int add(int version, int idx, ValueType val) {
+		return addVersion(update(roots[version], 0, n - 1, idx, val, true));
+	}
+
+	/**
+	 * Only for sum trees storing counters (e.g. version i + 1 = version i after add(i, compressed(a[i]), 1)).
+	 * Returns the smallest index idx such that the sum of the differences between versionR and versionL in [0, idx] is at
+	 * least k (k >= 1), i.e. the k-th smallest compressed value of a[versionL..versionR - 1] in the example.
+	 */
+	int kth(int versionL, int versionR, ValueType k) {
+		return kth(roots[versionL], roots[versionR], 0, n - 1, k);
+	}
+};
+
+/** Persistent segment tree with point update range query to get sum of values in the given interval */
+template<typename ValueType> struct SumCombinePPURQ { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};
+template<typename ValueType> struct SumDefaultValuePPURQ { ValueType operator()() { return 0; }};
+template<typename ValueType>
+using PersistentSegmentTreePointUpdateRangeQuerySum =
+		PersistentSegmentTreePointUpdateRangeQuery<ValueType, SumCombinePPURQ<ValueType>, SumDefaultValuePPURQ<ValueType>>;
+
+/** Persistent segment tree with point update range query to get min value in the given interval */
+template<typename ValueType> struct MinCombinePPURQ { ValueType operator()(ValueType val1, ValueType val2) { return std::min(val1, val2); }};
+template<typename ValueType> struct MinDefaultValuePPURQ { ValueType operator()() { return std::numeric_limits<ValueType>::max(); }};
+template<typename ValueType>
+using PersistentSegmentTreePointUpdateRangeQueryMin =
+		PersistentSegmentTreePointUpdateRangeQuery<ValueType, MinCombinePPURQ<ValueType>, MinDefaultValuePPURQ<ValueType>>;
+
+/** Persistent segment tree with point update range query to get max value in the given interval */
+template<typename ValueType> struct MaxCombinePPURQ { ValueType operator()(ValueType val1, ValueType val2) { return std::max(val1, val2); }};
+template<typename ValueType> struct MaxDefaultValuePPURQ { ValueType operator()() { return std::numeric_limits<ValueType>::min(); }};
+template<typename ValueType>
+using PersistentSegmentTreePointUpdateRangeQueryMax =
+		PersistentSegmentTreePointUpdateRangeQuery<ValueType, MaxCombinePPURQ<ValueType>, MaxDefaultValuePPURQ<ValueType>>;
@@ -0,0 +1,90 @@
+#include <bits/stdc++.h>
+
+using namespace std;
+
+#include "segment_tree_point_update_range_query.hpp"
+#include "merge_sort_segment_tree_range_query.hpp"
+
+/**
+ * Benchmark of the multi-threaded build(size, arr, threads) of SegmentTreePointUpdateRangeQuery,
+ * MergeSortSegmentTreeRangeQuery and MergeSortSegmentTreeFlatRangeQuery against their single-threaded
+ * build(size, arr), on a random array, with 1, 2, 4, ... threads up to the given maximum (the number of cores by
+ * default). Every build is checked with the same random queries.
+ * Usage: segment_tree_parallel_build_bench [n] [max threads]
+ * Build it with optimizations (e.g. g++ -std=c++17 -O2 -pthread).
+ */
+
+const int MaxN = 1 << 22;
+
+SegmentTreePointUpdateRangeQuerySum<long long, MaxN> segmentTree;
+MergeSortSegmentTreeRangeQuerySumGreater<int, MaxN> mergeSortTree;
+MergeSortSegmentTreeFlatRangeQuerySumGreater<int> flatMergeSortTree;
+
+template<typename Func>
+double measure(Func func) {
+	auto start = chrono::steady_clock::now();
+	func();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Times build(arr) (serial) and then build(arr, threads) for every thread count, printing the speedups. checksum()
+ * answers some queries on the last built tree, they must match the ones of the serial build.
+ */
+template<typename Build, typename ParallelBuild, typename Checksum>
+void compare(const char* name, const vector<int>& threadCounts, Build build, ParallelBuild parallelBuild, Checksum checksum) {
+	build(); // warm up the memory of the tree
+	double serial = measure(build);
+	long long expected = checksum();
+	printf("%-16s serial %.3fs", name, serial);
+	for (int threads : threadCounts) {
+		double time = measure([&]() { parallelBuild(threads); });
+		printf(", %d threads %.3fs (%.2fx)%s", threads, time, serial / time, checksum() == expected ? "" : " WRONG");
+	}
+	printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+	int n = argc > 1 ? min(atoi(argv[1]), MaxN) : MaxN;
+	int maxThreads = argc > 2 ? atoi(argv[2]) : max(1, (int)thread::hardware_concurrency());
+	vector<int> threadCounts;
+	for (int threads = 1; threads <= maxThreads; threads *= 2) threadCounts.push_back(threads);
+	if (threadCounts.back() != maxThreads) threadCounts.push_back(maxThreads);
+
+	mt19937 rng(12345);
+	vector<int> arr(n);
+	for (int& x : arr) x = rng() % 1000000000;
+	vector<long long> arr64(arr.begin(), arr.end());
+	vector<array<int, 3>> queries(1000);
+	for (auto& [l, r, val] : queries) {
+		l = rng() % n, r = rng() % n, val = rng() % 1000000000;
+		if (l > r) swap(l, r);
+	}
+	printf("n = %d, %d cores\n", n, (int)thread::hardware_concurrency());
+
+	compare("segment tree", threadCounts,
+	        [&]() { segmentTree.build(n, arr64.data()); },
+	        [&](int threads) { segmentTree.build(n, arr64.data(), threads); },
+	        [&]() {
+		        long long res = 0;
+		        for (const auto& [l, r, val] : queries) res += segmentTree.query(l, r);
+		        return res;
+	        });
+	compare("merge sort tree", threadCounts,
+	        [&]() { mergeSortTree.build(n, arr.data()); },
+	        [&](int threads) { mergeSortTree.build(n, arr.data(), threads); },
+	        [&]() {
+		        long long res = 0;
+		        for (const auto& [l, r, val] : queries) res += mergeSortTree.query(l, r, val);
+		        return res;
+	        });
+	compare("flat merge sort", threadCounts,
+	        [&]() { flatMergeSortTree.build(n, arr.data()); },
+	        [&](int threads) { flatMergeSortTree.build(n, arr.data(), threads); },
+	        [&]() {
+		        long long res = 0;
+		        for (const auto& [l, r, val] : queries) res += flatMergeSortTree.query(l, r, val);
+		        return res;
+	        });
+	return 0;
+}
@@ -15,10 +15,12 @@
 template<typename ValueType, int MaxSize, typename CombineFunc, typename DefaultValueFunc>
 class SegmentTreePointUpdateRangeQuery {
 private:
+	static constexpr int ParallelMinSize = 1 << 15; // smaller subtrees are built by a single thread
+
 	int n;
 	ValueType st[MaxSize * 4];
-	CombineFunc combine;
-	DefaultValueFunc defaultValueFunc;
+	mutable CombineFunc combine; // mutable so the const batch query can call it (the functors are stateless)
+	mutable DefaultValueFunc defaultValueFunc;
 
 	void build(int v, int tl, int tr, ValueType val) {
 		if (tl == tr) st[v] = val;
@@ -40,6 +42,19 @@ private:
 		}
 	}
 
+	/** Builds the children in parallel, splitting the threads between them, until the subtrees are small. */
+	void build(ValueType arr[], int v, int tl, int tr, int threads) {
+		if (threads <= 1 || tr - tl < ParallelMinSize) {
+			build(arr, v, tl, tr);
+			return;
+		}
+		int tm = (tl + tr) / 2;
+		auto left = std::async(std::launch::async, [&]() { build(arr, v * 2, tl, tm, threads / 2); });
+		build(arr, v * 2 + 1, tm + 1, tr, threads - threads / 2);
+		left.get();
+		st[v] = combine(st[v * 2], st[v * 2 + 1]);
+	}
+
 	ValueType query(int v, int tl, int tr, int l, int r) {
 		if (l > r) return defaultValueFunc();
 		if (l == tl && r == tr) return st[v];
@@ -59,6 +74,63 @@ private:
 		}
 	}
 
+	// Every query in ids intersects [tl, tr]: the ones covering it take its value and the rest go down to the children.
+	// batchLeft[d] and batchRight[d] are the queries going down to the left/right child of the node of depth d.
+	void query(int v, int tl, int tr, int depth, const std::vector<int>& ids, const std::pair<int, int>* ranges, ValueType* out,
+	           std::vector<std::vector<int>>& batchLeft, std::vector<std::vector<int>>& batchRight) const {
+		std::vector<int>& left = batchLeft[depth];
+		std::vector<int>& right = batchRight[depth];
+		left.clear();
+		right.clear();
+		int tm = (tl + tr) / 2;
+		for (int id : ids) {
+			int l = ranges[id].first, r = ranges[id].second;
+			if (l <= tl && tr <= r) out[id] = combine(out[id], st[v]);
+			else {
+				if (l <= tm) left.push_back(id);
+				if (r > tm) right.push_back(id);
+			}
+		}
+		if (!left.empty()) query(v * 2, tl, tm, depth + 1, left, ranges, out, batchLeft, batchRight);
+		if (!right.empty()) query(v * 2 + 1, tm + 1, tr, depth + 1, right, ranges, out, batchLeft, batchRight);
+	}
+
+	// Returns the first index >= l where pred fails (accumulating the values before it in acc), or -1 if there is none
+	template<typename Predicate>
+	int maxRight(int v, int tl, int tr, int l, Predicate& pred, ValueType& acc) {
+		if (tr < l) return -1;
+		if (l <= tl) {
+			ValueType next = combine(acc, st[v]);
+			if (pred(next)) {
+				acc = next;
+				return -1;
+			}
+			if (tl == tr) return tl;
+		}
+		int tm = (tl + tr) / 2;
+		int res = maxRight(v * 2, tl, tm, l, pred, acc);
+		if (res != -1) return res;
+		return maxRight(v * 2 + 1, tm + 1, tr, l, pred, acc);
+	}
+
+	// Returns the last index <= r where pred fails (accumulating the values after it in acc), or -1 if there is none
+	template<typename Predicate>
+	int minLeft(int v, int tl, int tr, int r, Predicate& pred, ValueType& acc) {
+		if (tl > r) return -1;
+		if (tr <= r) {
+			ValueType next = combine(st[v], acc);
+			if (pred(next)) {
+				acc = next;
+				return -1;
+			}
+			if (tl == tr) return tl;
+		}
+		int tm = (tl + tr) / 2;
+		int res = minLeft(v * 2 + 1, tm + 1, tr, r, pred, acc);
+		if (res != -1) return res;
+		return minLeft(v * 2, tl, tm, r, pred, acc);
+	}
+
 public:
 
 	void build(int size) {
@@ -76,6 +148,15 @@ public:
 		build(arr, 1, 0, size - 1);
 	}
 
+	/**
+	 * Same as build(size, arr) using up to the given number of threads (e.g. std::thread::hardware_concurrency()),
+	 * each one building a whole subtree. CombineFunc must be safe to call concurrently (stateless functors are).
+	 */
+	void build(int size, ValueType* arr, int threads) {
+		n = size;
+		build(arr, 1, 0, size - 1, threads);
+	}
+
 	ValueType query(int l, int r) {
 		return query(1, 0, n - 1, l, r);
 	}
@@ -83,6 +164,58 @@ public:
 	void update(int idx, ValueType val) {
 		update(1, 0, n - 1, idx, val);
 	}
+
+	/**
+	 * Returns the largest r in [l - 1, n - 1] such that pred(query(l, r)) is true, in O(log(n)).
+	 * pred must be true for the default value and monotone (once false, it stays false as r grows),
+	 * e.g. the first index where the prefix sum from l exceeds x is maxRight(l, [x](ValueType s) { return s <= x; }) + 1.
+	 */
+	template<typename Predicate>
+	int maxRight(int l, Predicate pred) {
+		ValueType acc = defaultValueFunc();
+		int res = maxRight(1, 0, n - 1, l, pred, acc);
+		return res == -1 ? n - 1 : res - 1;
+	}
+
+	/**
+	 * Returns the smallest l in [0, r + 1] such that pred(query(l, r)) is true, in O(log(n)).
+	 * pred must be true for the default value and monotone (once false, it stays false as l decreases).
+	 */
+	template<typename Predicate>
+	int minLeft(int r, Predicate pred) {
+		ValueType acc = defaultValueFunc();
+		int res = minLeft(1, 0, n - 1, r, pred, acc);
+		return res == -1 ? 0 : res + 1;
+	}
+
+	/**
+	 * Answers out[i] = query(ranges[i].first, ranges[i].second) for count queries at once.
+	 * Queries are grouped by their left end (counting sort) and answered in blocks of BatchSize with a single tree walk
+	 * per block, so the nodes shared by nearby queries are loaded once per block instead of once per query.
+	 * The scratch lists are local and the tree is not modified, so several threads can answer batches on the same tree.
+	 */
+	void query(int count, const std::pair<int, int>* ranges, ValueType* out) const {
+		const int BatchSize = 1024, Buckets = 1 << 16;
+		std::vector<int> start(Buckets + 1, 0), order(count);
+		auto bucket = [&](int i) { return (int)((long long)ranges[i].first * Buckets / n); };
+		for (int i = 0; i < count; i++) {
+			out[i] = defaultValueFunc();
+			if (ranges[i].first <= ranges[i].second) start[bucket(i) + 1]++;
+		}
+		for (int b = 0; b < Buckets; b++) start[b + 1] += start[b];
+		int valid = start[Buckets];
+		for (int i = 0; i < count; i++)
+			if (ranges[i].first <= ranges[i].second) order[start[bucket(i)]++] = i;
+
+		int depth = 2;
+		while ((1 << (depth - 2)) < n) depth++;
+		std::vector<std::vector<int>> batchLeft(depth), batchRight(depth);
+		std::vector<int> ids;
+		for (int begin = 0; begin < valid; begin += BatchSize) {
+			ids.assign(order.begin() + begin, order.begin() + std::min(valid, begin + BatchSize));
+			query(1, 0, n - 1, 0, ids, ranges, out, batchLeft, batchRight);
+		}
+	}
 };
 
 /** Segment tree with point update range query to get sum of values in the given interval */
@@ -164,4 +297,192 @@ struct MaxSumCombinePURQ {
 };
 template<typename ValueType, int MaxSize>
 using SegmentTreePointUpdateRangeQueryMaxSum =
-		SegmentTreePointUpdateRangeQuery<ValueType, MaxSize, MaxSumCombinePURQ<ValueType>, MaxSumDefaultValuePURQ<ValueType>>;
+		SegmentTreePointUpdateRangeQuery<Data<ValueType>, MaxSize, MaxSumCombinePURQ<ValueType>, MaxSumDefaultValuePURQ<ValueType>>;
+
+/**
+ * \brief Defines a class for an iterative (bottom-up) Segment Tree, using 2 * n nodes instead of 4 * n.
+ *        Leaves are stored in st[n, 2 * n) and node i is the parent of nodes 2 * i and 2 * i + 1, so query and update are
+ *        plain loops without recursion. Left and right partial answers are kept apart, so non-commutative combine
+ *        functions (e.g. MaxSumCombinePURQ) are supported.
+ *        State: untested.
+ *        Ref: https://codeforces.com/blog/entry/18051
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam MaxSize Maximum number of elements.
+ * \tparam CombineFunc Function to combine intervals and partial answers (same as in SegmentTreePointUpdateRangeQuery).
+ * \tparam DefaultValueFunc Function returning the identity value of CombineFunc (same as in SegmentTreePointUpdateRangeQuery).
+ */
+template<typename ValueType, int MaxSize, typename CombineFunc, typename DefaultValueFunc>
+class SegmentTreeBottomUpPointUpdateRangeQuery {
+private:
+	int n;
+	ValueType st[MaxSize * 2];
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+
+	void buildParents() {
+		for (int i = n - 1; i > 0; i--) st[i] = combine(st[i * 2], st[i * 2 + 1]);
+	}
+
+public:
+
+	void build(int size) {
+		build(size, defaultValueFunc());
+	}
+
+	void build(int size, ValueType val) {
+		n = size;
+		std::fill(st + n, st + n * 2, val);
+		buildParents();
+	}
+
+	void build(int size, ValueType* arr) {
+		n = size;
+		std::copy(arr, arr + n, st + n);
+		buildParents();
+	}
+
+	ValueType query(int l, int r) {
+		ValueType resL = defaultValueFunc(), resR = defaultValueFunc();
+		for (l += n, r += n + 1; l < r; l /= 2, r /= 2) {
+			if (l & 1) resL = combine(resL, st[l++]);
+			if (r & 1) resR = combine(st[--r], resR);
+		}
+		return combine(resL, resR);
+	}
+
+	void update(int idx, ValueType val) {
+		for (st[idx += n] = val; idx > 1; idx /= 2) st[idx / 2] = combine(st[idx & ~1], st[idx | 1]);
+	}
+};
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeBottomUpPointUpdateRangeQuerySum =
+		SegmentTreeBottomUpPointUpdateRangeQuery<ValueType, MaxSize, SumCombinePURQ<ValueType>, SumDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeBottomUpPointUpdateRangeQueryMin =
+		SegmentTreeBottomUpPointUpdateRangeQuery<ValueType, MaxSize, MinCombinePURQ<ValueType>, MinDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeBottomUpPointUpdateRangeQueryMax =
+		SegmentTreeBottomUpPointUpdateRangeQuery<ValueType, MaxSize, MaxCombinePURQ<ValueType>, MaxDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeBottomUpPointUpdateRangeQueryMaxWithCounter =
+		SegmentTreeBottomUpPointUpdateRangeQuery<std::pair<ValueType, ValueType>, MaxSize, CombinePairPURQ<ValueType>, PairDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeBottomUpPointUpdateRangeQueryLcm =
+		SegmentTreeBottomUpPointUpdateRangeQuery<ValueType, MaxSize, LcmCombinePURQ<ValueType>, LcmDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeBottomUpPointUpdateRangeQueryGcd =
+		SegmentTreeBottomUpPointUpdateRangeQuery<ValueType, MaxSize, GcdCombinePURQ<ValueType>, GcdDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeBottomUpPointUpdateRangeQueryMaxSum =
+		SegmentTreeBottomUpPointUpdateRangeQuery<Data<ValueType>, MaxSize, MaxSumCombinePURQ<ValueType>, MaxSumDefaultValuePURQ<ValueType>>;
+
+/**
+ * \brief Defines a class for an iterative (bottom-up) 2D Segment Tree, a bottom-up segment tree over the rows whose
+ *        nodes are bottom-up segment trees over the columns. The node (i, j) aggregates the rows of the row node i and
+ *        the columns of the column node j, so a rectangle is covered by O(log(rows) * log(cols)) nodes.
+ *        Unlike FenwickTree2DPointUpdateRangeQuery it doesn't need an inverse, so it works with min, max, gcd, etc.
+ *        CombineFunc must be commutative (the order of the rows and columns is not kept).
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/segment_tree.html#generalization-to-higher-dimensions
+ *             https://codeforces.com/blog/entry/18051
+ *
+ * \details Build: O(rows * cols)
+ *          Query: O(log(rows) * log(cols))
+ *          Update: O(log(rows) * log(cols))
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam MaxRows Maximum number of rows.
+ * \tparam MaxCols Maximum number of columns.
+ * \tparam CombineFunc Function to combine intervals and partial answers (same as in SegmentTreePointUpdateRangeQuery).
+ * \tparam DefaultValueFunc Function returning the identity value of CombineFunc (same as in SegmentTreePointUpdateRangeQuery).
+ */
+template<typename ValueType, int MaxRows, int MaxCols, typename CombineFunc, typename DefaultValueFunc>
+class SegmentTree2DPointUpdateRangeQuery {
+private:
+	int n, m;
+	ValueType st[MaxRows * 2][MaxCols * 2];
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+
+	void buildParents() {
+		for (int i = n; i < n * 2; i++)
+			for (int j = m - 1; j > 0; j--) st[i][j] = combine(st[i][j * 2], st[i][j * 2 + 1]);
+		for (int i = n - 1; i > 0; i--)
+			for (int j = 1; j < m * 2; j++) st[i][j] = combine(st[i * 2][j], st[i * 2 + 1][j]);
+	}
+
+	ValueType queryCols(int i, int c1, int c2) {
+		ValueType res = defaultValueFunc();
+		for (c1 += m, c2 += m + 1; c1 < c2; c1 /= 2, c2 /= 2) {
+			if (c1 & 1) res = combine(res, st[i][c1++]);
+			if (c2 & 1) res = combine(res, st[i][--c2]);
+		}
+		return res;
+	}
+
+public:
+
+	void build(int rows, int cols) {
+		build(rows, cols, defaultValueFunc());
+	}
+
+	void build(int rows, int cols, ValueType val) {
+		n = rows;
+		m = cols;
+		for (int i = n; i < n * 2; i++) std::fill(st[i] + m, st[i] + m * 2, val);
+		buildParents();
+	}
+
+	/** arr is stored by rows: the element (i, j) is arr[i * cols + j]. */
+	void build(int rows, int cols, ValueType* arr) {
+		n = rows;
+		m = cols;
+		for (int i = 0; i < n; i++) std::copy(arr + i * m, arr + (i + 1) * m, st[n + i] + m);
+		buildParents();
+	}
+
+	/** Combination of the elements in the rectangle with corners (r1, c1) and (r2, c2) (inclusive). */
+	ValueType query(int r1, int c1, int r2, int c2) {
+		ValueType res = defaultValueFunc();
+		for (r1 += n, r2 += n + 1; r1 < r2; r1 /= 2, r2 /= 2) {
+			if (r1 & 1) res = combine(res, queryCols(r1++, c1, c2));
+			if (r2 & 1) res = combine(res, queryCols(--r2, c1, c2));
+		}
+		return res;
+	}
+
+	void update(int row, int col, ValueType val) {
+		int i = row + n, j = col + m;
+		for (st[i][j] = val; j > 1; j /= 2) st[i][j / 2] = combine(st[i][j & ~1], st[i][j | 1]);
+		for (i /= 2; i > 0; i /= 2)
+			for (j = col + m; j > 0; j /= 2) st[i][j] = combine(st[i * 2][j], st[i * 2 + 1][j]);
+	}
+};
+
+template<typename ValueType, int MaxRows, int MaxCols = MaxRows>
+using SegmentTree2DPointUpdateRangeQuerySum =
+		SegmentTree2DPointUpdateRangeQuery<ValueType, MaxRows, MaxCols, SumCombinePURQ<ValueType>, SumDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxRows, int MaxCols = MaxRows>
+using SegmentTree2DPointUpdateRangeQueryMin =
+		SegmentTree2DPointUpdateRangeQuery<ValueType, MaxRows, MaxCols, MinCombinePURQ<ValueType>, MinDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxRows, int MaxCols = MaxRows>
+using SegmentTree2DPointUpdateRangeQueryMax =
+		SegmentTree2DPointUpdateRangeQuery<ValueType, MaxRows, MaxCols, MaxCombinePURQ<ValueType>, MaxDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxRows, int MaxCols = MaxRows>
+using SegmentTree2DPointUpdateRangeQueryLcm =
+		SegmentTree2DPointUpdateRangeQuery<ValueType, MaxRows, MaxCols, LcmCombinePURQ<ValueType>, LcmDefaultValuePURQ<ValueType>>;
+
+template<typename ValueType, int MaxRows, int MaxCols = MaxRows>
+using SegmentTree2DPointUpdateRangeQueryGcd =
+		SegmentTree2DPointUpdateRangeQuery<ValueType, MaxRows, MaxCols, GcdCombinePURQ<ValueType>, GcdDefaultValuePURQ<ValueType>>;
@@ -0,0 +1,87 @@
+#include <bits/stdc++.h>
+
+using namespace std;
+
+#include "segment_tree_point_update_range_query.hpp"
+
+/**
+ * Benchmark of SegmentTreeBottomUpPointUpdateRangeQuery against the recursive SegmentTreePointUpdateRangeQuery, on
+ * the same random mix of point updates and range queries (half and half), with a commutative combine function (sum)
+ * and a non-commutative one (maximal subsegment sum).
+ * Usage: segment_tree_point_update_range_query_bench [n] [operations]
+ * Build it with optimizations (e.g. g++ -std=c++17 -O2, or cmake -DCMAKE_BUILD_TYPE=Release).
+ */
+
+const int MaxN = 1 << 20;
+
+struct Operation {
+	bool isUpdate;
+	int a, b;
+};
+
+SegmentTreePointUpdateRangeQuerySum<long long, MaxN> recursiveSum;
+SegmentTreeBottomUpPointUpdateRangeQuerySum<long long, MaxN> bottomUpSum;
+SegmentTreePointUpdateRangeQueryMaxSum<long long, MaxN> recursiveMaxSum;
+SegmentTreeBottomUpPointUpdateRangeQueryMaxSum<long long, MaxN> bottomUpMaxSum;
+
+template<typename Func>
+double measure(Func func) {
+	auto start = chrono::steady_clock::now();
+	func();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/** Runs the operations, returning a checksum of the answers. Updates set the element a to the value b. */
+template<typename Tree, typename Convert, typename Answer>
+long long run(Tree& tree, const vector<Operation>& ops, Convert convert, Answer answer) {
+	long long checksum = 0;
+	for (const Operation& op : ops) {
+		if (op.isUpdate) tree.update(op.a, convert(op.b));
+		else checksum += answer(tree.query(op.a, op.b));
+	}
+	return checksum;
+}
+
+template<typename Recursive, typename BottomUp, typename ValueType, typename Convert, typename Answer>
+void compare(const char* name, Recursive& recursive, BottomUp& bottomUp, vector<ValueType>& arr, const vector<Operation>& ops,
+             Convert convert, Answer answer) {
+	int n = arr.size();
+	long long checksumRecursive = 0, checksumBottomUp = 0;
+	double timeRecursive = measure([&]() {
+		recursive.build(n, arr.data());
+		checksumRecursive = run(recursive, ops, convert, answer);
+	});
+	double timeBottomUp = measure([&]() {
+		bottomUp.build(n, arr.data());
+		checksumBottomUp = run(bottomUp, ops, convert, answer);
+	});
+	printf("%-8s recursive %.3fs, bottom-up %.3fs (%.2fx)%s\n", name, timeRecursive, timeBottomUp, timeRecursive / timeBottomUp,
+	       checksumRecursive == checksumBottomUp ? "" : " ANSWERS DIFFER");
+}
+
+int main(int argc, char* argv[]) {
+	int n = argc > 1 ? min(atoi(argv[1]), MaxN) : MaxN;
+	int operations = argc > 2 ? atoi(argv[2]) : 10000000;
+
+	mt19937 rng(12345);
+	vector<Operation> ops(operations);
+	for (Operation& op : ops) {
+		op.isUpdate = rng() & 1;
+		if (op.isUpdate) op = { true, (int)(rng() % n), (int)(rng() % 2001) - 1000 };
+		else {
+			int l = rng() % n, r = rng() % n;
+			op = { false, min(l, r), max(l, r) };
+		}
+	}
+	printf("n = %d, %d operations\n", n, operations);
+
+	vector<long long> arr(n);
+	for (long long& x : arr) x = (int)(rng() % 2001) - 1000;
+	compare("sum", recursiveSum, bottomUpSum, arr, ops, [](int x) { return (long long)x; }, [](long long x) { return x; });
+
+	vector<Data<long long>> data(n);
+	for (int i = 0; i < n; i++) data[i] = Data<long long>(arr[i], arr[i], arr[i], arr[i]);
+	compare("max-sum", recursiveMaxSum, bottomUpMaxSum, data, ops, [](int x) { return Data<long long>(x, x, x, x); },
+	        [](const Data<long long>& d) { return d.ans; });
+	return 0;
+}
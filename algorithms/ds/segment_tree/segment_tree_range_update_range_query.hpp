@@ -1,29 +1,51 @@
 
 /**
- * \brief Defines a class for a Segment Tree.
- *        State: tested.
+ * \brief Defines a class for a Segment Tree with lazy propagation.
+ *        Node values form a monoid (CombineFunc, DefaultValueFunc) and range updates are elements of LazyType, which are
+ *        applied to a whole node with ApplyFunc and merged with the pending update of the node with ComposeFunc.
+ *        All of them are functors given as template parameters, so push and apply are inlined.
+ *        State: untested.
  *        Ref: Competitive Programming 3, section 2.4.3
  *             https://cp-algorithms.com/data_structures/segment_tree.html
+ *             https://atcoder.github.io/ac-library/production/document_en/lazysegtree.html
  *
  * \tparam ValueType Type of the elements.
  * \tparam MaxSize Maximum number of elements.
- * \tparam ElementCompare Comparator function to combine intervals and partial answers
+ * \tparam CombineFunc Function to combine intervals and partial answers
  *         (e.g. struct SumCombine { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};).
  * \tparam DefaultValueFunc Function returning the default value, used when calling with an undefined interval (l > r)
  *         (e.g. struct SumDefaultValue { ValueType operator()() { return 0; }};).
- *         // TODO complete documentation of new parameters
+ * \tparam LazyType Type of the range updates. A value initialized LazyType() must be the identity update.
+ * \tparam ApplyFunc Function applying an update to the value of an interval of the given length
+ *         (e.g. struct SumAddApply { ValueType operator()(ValueType val, ValueType upd, int len) { return val + upd * len; }};).
+ * \tparam ComposeFunc Function returning the update equivalent to applying old and then upd
+ *         (e.g. struct AddCompose { ValueType operator()(ValueType upd, ValueType old) { return upd + old; }};).
  */
-template<typename ValueType, int MaxSize, typename CombineFunc, typename DefaultValueFunc>
+template<typename ValueType, int MaxSize, typename CombineFunc, typename DefaultValueFunc,
+		typename LazyType, typename ApplyFunc, typename ComposeFunc>
 class SegmentTreeRangeUpdateRangeQuery {
 private:
 	int n;
-	ValueType st[MaxSize * 4], lazyUpdate[MaxSize * 4], lazyAdd[MaxSize * 4];
+	ValueType st[MaxSize * 4];
+	LazyType lazy[MaxSize * 4];
+	mutable CombineFunc combine; // mutable so the const batch query can call them (the functors are stateless)
+	mutable DefaultValueFunc defaultValueFunc;
+	mutable ApplyFunc applyFunc;
+	mutable ComposeFunc compose;
 
-	ValueType combine(ValueType a, ValueType b) { return a + b; }
+	void build(int v, int tl, int tr, ValueType val) {
+		lazy[v] = LazyType();
+		if (tl == tr) st[v] = val;
+		else {
+			int tm = (tl + tr) / 2;
+			build(v * 2, tl, tm, val);
+			build(v * 2 + 1, tm + 1, tr, val);
+			st[v] = combine(st[v * 2], st[v * 2 + 1]);
+		}
+	}
 
 	void build(ValueType arr[], int v, int tl, int tr) {
-		lazyUpdate[v] = -1;
-		lazyAdd[v] = 0;
+		lazy[v] = LazyType();
 		if (tl == tr) st[v] = arr[tl];
 		else {
 			int tm = (tl + tr) / 2;
@@ -33,28 +55,20 @@ private:
 		}
 	}
 
+	void apply(int v, int len, const LazyType& upd) {
+		st[v] = applyFunc(st[v], upd, len);
+		lazy[v] = compose(upd, lazy[v]);
+	}
+
 	void push(int v, int tl, int tr) {
 		int tm = (tl + tr) / 2;
-		if (lazyUpdate[v] != -1) {
-			st[v * 2] = lazyUpdate[v] * (tm - tl + 1);
-			lazyUpdate[v * 2] = lazyUpdate[v];
-			lazyAdd[v * 2] = 0;
-			st[v * 2 + 1] = lazyUpdate[v] * (tr - tm);
-			lazyUpdate[v * 2 + 1] = lazyUpdate[v];
-			lazyAdd[v * 2 + 1] = 0;
-			lazyUpdate[v] = -1;
-		}
-		if (lazyAdd[v] != 0) {
-			st[v * 2] += ((tm - tl + 1) * lazyAdd[v]);
-			lazyAdd[v * 2] += lazyAdd[v];
-			st[v * 2 + 1] += ((tr - tm) * lazyAdd[v]);
-			lazyAdd[v * 2 + 1] += lazyAdd[v];
-			lazyAdd[v] = 0;
-		}
+		apply(v * 2, tm - tl + 1, lazy[v]);
+		apply(v * 2 + 1, tr - tm, lazy[v]);
+		lazy[v] = LazyType();
 	}
 
 	ValueType query(int v, int tl, int tr, int l, int r) {
-		if (l > r) return 0;
+		if (l > r) return defaultValueFunc();
 		if (l == tl && r == tr) return st[v];
 		push(v, tl, tr);
 		int tm = (tl + tr) / 2;
@@ -62,49 +76,92 @@ private:
 		               query(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r));
 	}
 
-	void update(int v, int tl, int tr, int l, int r, ValueType val) {
+	void update(int v, int tl, int tr, int l, int r, const LazyType& upd) {
 		if (l > r) return;
-		if (l == tl && r == tr) {
-			st[v] = (tr - tl + 1) * val;
-			lazyUpdate[v] = val;
-			lazyAdd[v] = 0;
-		} else {
+		if (l == tl && r == tr) apply(v, tr - tl + 1, upd);
+		else {
 			push(v, tl, tr);
-
 			int tm = (tl + tr) / 2;
-			update(v * 2, tl, tm, l, std::min(r, tm), val);
-			update(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, val);
+			update(v * 2, tl, tm, l, std::min(r, tm), upd);
+			update(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, upd);
 			st[v] = combine(st[v * 2], st[v * 2 + 1]);
 		}
 	}
 
-	void add(int v, int tl, int tr, int l, int r, ValueType val) {
-		if (l > r) return;
-		if (l == tl && r == tr) {
-			st[v] += ((tr - tl + 1) *val);
-			lazyAdd[v] += val;
-		} else {
-			push(v, tl, tr);
+	// Every query in ids intersects [tl, tr]: the ones covering it take its value and the rest go down to the children.
+	// pending is the composition of the updates of the ancestors not pushed to this node yet, it is applied to the values
+	// read instead of being pushed. batchLeft[d] and batchRight[d] are the queries going down to the left/right child of
+	// the node of depth d.
+	void query(int v, int tl, int tr, int depth, const LazyType& pending, const std::vector<int>& ids,
+	           const std::pair<int, int>* ranges, ValueType* out, std::vector<std::vector<int>>& batchLeft,
+	           std::vector<std::vector<int>>& batchRight) const {
+		std::vector<int>& left = batchLeft[depth];
+		std::vector<int>& right = batchRight[depth];
+		left.clear();
+		right.clear();
+		int tm = (tl + tr) / 2;
+		for (int id : ids) {
+			int l = ranges[id].first, r = ranges[id].second;
+			if (l <= tl && tr <= r) out[id] = combine(out[id], applyFunc(st[v], pending, tr - tl + 1));
+			else {
+				if (l <= tm) left.push_back(id);
+				if (r > tm) right.push_back(id);
+			}
+		}
+		if (left.empty() && right.empty()) return;
+		LazyType childPending = compose(pending, lazy[v]);
+		if (!left.empty()) query(v * 2, tl, tm, depth + 1, childPending, left, ranges, out, batchLeft, batchRight);
+		if (!right.empty()) query(v * 2 + 1, tm + 1, tr, depth + 1, childPending, right, ranges, out, batchLeft, batchRight);
+	}
 
-			int tm = (tl + tr) / 2;
-			add(v * 2, tl, tm, l, std::min(r, tm), val);
-			add(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, val);
-			st[v] = combine(st[v * 2], st[v * 2 + 1]);
+	// Returns the first index >= l where pred fails (accumulating the values before it in acc), or -1 if there is none
+	template<typename Predicate>
+	int maxRight(int v, int tl, int tr, int l, Predicate& pred, ValueType& acc) {
+		if (tr < l) return -1;
+		if (l <= tl) {
+			ValueType next = combine(acc, st[v]);
+			if (pred(next)) {
+				acc = next;
+				return -1;
+			}
+			if (tl == tr) return tl;
 		}
+		push(v, tl, tr);
+		int tm = (tl + tr) / 2;
+		int res = maxRight(v * 2, tl, tm, l, pred, acc);
+		if (res != -1) return res;
+		return maxRight(v * 2 + 1, tm + 1, tr, l, pred, acc);
+	}
+
+	// Returns the last index <= r where pred fails (accumulating the values after it in acc), or -1 if there is none
+	template<typename Predicate>
+	int minLeft(int v, int tl, int tr, int r, Predicate& pred, ValueType& acc) {
+		if (tl > r) return -1;
+		if (tr <= r) {
+			ValueType next = combine(st[v], acc);
+			if (pred(next)) {
+				acc = next;
+				return -1;
+			}
+			if (tl == tr) return tl;
+		}
+		push(v, tl, tr);
+		int tm = (tl + tr) / 2;
+		int res = minLeft(v * 2 + 1, tm + 1, tr, r, pred, acc);
+		if (res != -1) return res;
+		return minLeft(v * 2, tl, tm, r, pred, acc);
 	}
 
 public:
 
 	void build(int size) {
 		n = size;
-		std::fill(st, st + (n * 4), 0);
-		std::fill(lazyUpdate, lazyUpdate + (n * 4), -1);
-		std::fill(lazyAdd, lazyAdd + (n * 4), 0);
+		build(1, 0, size - 1, defaultValueFunc());
 	}
 
 	void build(int size, ValueType val) {
-		build(size);
-		update(1, val);
+		n = size;
+		build(1, 0, size - 1, val);
 	}
 
 	void build(int size, ValueType* arr) {
@@ -116,12 +173,102 @@ public:
 		return query(1, 0, n - 1, l, r);
 	}
 
-	void update(int l, int r, ValueType val) {
-		update(1, 0, n - 1, l, r, val);
+	void update(int l, int r, const LazyType& upd) {
+		update(1, 0, n - 1, l, r, upd);
 	}
 
+	/** Only available if LazyType provides a static add(ValueType) function (e.g. AssignAddLazyRURQ, AffineLazyRURQ). */
 	void add(int l, int r, ValueType val) {
-		add(1, 0, n - 1, l, r, val);
+		update(1, 0, n - 1, l, r, LazyType::add(val));
+	}
+
+	/**
+	 * Returns the largest r in [l - 1, n - 1] such that pred(query(l, r)) is true, in O(log(n)).
+	 * pred must be true for the default value and monotone (once false, it stays false as r grows),
+	 * e.g. the first index >= l with a value less than x in a min tree is maxRight(l, [x](ValueType m) { return m >= x; }) + 1.
+	 */
+	template<typename Predicate>
+	int maxRight(int l, Predicate pred) {
+		ValueType acc = defaultValueFunc();
+		int res = maxRight(1, 0, n - 1, l, pred, acc);
+		return res == -1 ? n - 1 : res - 1;
+	}
+
+	/**
+	 * Returns the smallest l in [0, r + 1] such that pred(query(l, r)) is true, in O(log(n)).
+	 * pred must be true for the default value and monotone (once false, it stays false as l decreases).
+	 */
+	template<typename Predicate>
+	int minLeft(int r, Predicate pred) {
+		ValueType acc = defaultValueFunc();
+		int res = minLeft(1, 0, n - 1, r, pred, acc);
+		return res == -1 ? 0 : res + 1;
+	}
+
+	/**
+	 * Answers out[i] = query(ranges[i].first, ranges[i].second) for count queries at once.
+	 * Queries are grouped by their left end (counting sort) and answered in blocks of BatchSize with a single tree walk
+	 * per block, so the nodes shared by nearby queries are loaded once per block instead of once per query.
+	 * Pending updates are applied on the way down instead of pushed and the scratch lists are local, so the tree is not
+	 * modified and several threads can answer batches on the same tree.
+	 */
+	void query(int count, const std::pair<int, int>* ranges, ValueType* out) const {
+		const int BatchSize = 1024, Buckets = 1 << 16;
+		std::vector<int> start(Buckets + 1, 0), order(count);
+		auto bucket = [&](int i) { return (int)((long long)ranges[i].first * Buckets / n); };
+		for (int i = 0; i < count; i++) {
+			out[i] = defaultValueFunc();
+			if (ranges[i].first <= ranges[i].second) start[bucket(i) + 1]++;
+		}
+		for (int b = 0; b < Buckets; b++) start[b + 1] += start[b];
+		int valid = start[Buckets];
+		for (int i = 0; i < count; i++)
+			if (ranges[i].first <= ranges[i].second) order[start[bucket(i)]++] = i;
+
+		int depth = 2;
+		while ((1 << (depth - 2)) < n) depth++;
+		std::vector<std::vector<int>> batchLeft(depth), batchRight(depth);
+		std::vector<int> ids;
+		for (int begin = 0; begin < valid; begin += BatchSize) {
+			ids.assign(order.begin() + begin, order.begin() + std::min(valid, begin + BatchSize));
+			query(1, 0, n - 1, 0, LazyType(), ids, ranges, out, batchLeft, batchRight);
+		}
+	}
+};
+
+/**
+ * Range assignment followed by a range addition. Constructing it from a value gives an assignment, so update(l, r, val)
+ * assigns val to the interval and add(l, r, val) adds val to it.
+ */
+template<typename ValueType> struct AssignAddLazyRURQ {
+	bool assigned;
+	ValueType assignValue, addValue;
+	AssignAddLazyRURQ() : assigned(false), assignValue(), addValue(0) {}
+	AssignAddLazyRURQ(ValueType val) : assigned(true), assignValue(val), addValue(0) {}
+	static AssignAddLazyRURQ add(ValueType val) {
+		AssignAddLazyRURQ res;
+		res.addValue = val;
+		return res;
+	}
+};
+template<typename ValueType> struct AssignAddComposeRURQ {
+	AssignAddLazyRURQ<ValueType> operator()(const AssignAddLazyRURQ<ValueType>& upd, AssignAddLazyRURQ<ValueType> old) {
+		if (upd.assigned) return upd;
+		old.addValue += upd.addValue;
+		return old;
+	}
+};
+
+/** Affine range update, x -> mul * x + add. For min/max queries mul must not be negative. */
+template<typename ValueType> struct AffineLazyRURQ {
+	ValueType mul, addValue;
+	AffineLazyRURQ() : mul(1), addValue(0) {}
+	AffineLazyRURQ(ValueType mul, ValueType addValue) : mul(mul), addValue(addValue) {}
+	static AffineLazyRURQ add(ValueType val) { return AffineLazyRURQ(1, val); }
+};
+template<typename ValueType> struct AffineComposeRURQ {
+	AffineLazyRURQ<ValueType> operator()(const AffineLazyRURQ<ValueType>& upd, const AffineLazyRURQ<ValueType>& old) {
+		return AffineLazyRURQ<ValueType>(upd.mul * old.mul, upd.mul * old.addValue + upd.addValue);
 	}
 };
 
@@ -130,9 +277,36 @@ template<typename ValueType> struct SumDefaultValueRURQ { ValueType operator()()
 
 template<typename ValueType> struct SumCombineRURQ { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};
 
+template<typename ValueType> struct SumAssignAddApplyRURQ {
+	ValueType operator()(ValueType val, const AssignAddLazyRURQ<ValueType>& upd, int len) {
+		return (upd.assigned ? upd.assignValue * len : val) + upd.addValue * len;
+	}
+};
+
+template<typename ValueType> struct SumAffineApplyRURQ {
+	ValueType operator()(ValueType val, const AffineLazyRURQ<ValueType>& upd, int len) { return upd.mul * val + upd.addValue * len; }
+};
+
 template<typename ValueType, int MaxSize>
 using SegmentTreeRangeUpdateRangeQuerySum =
-		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, SumCombineRURQ<ValueType>, SumDefaultValueRURQ<ValueType>>;
+		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, SumCombineRURQ<ValueType>, SumDefaultValueRURQ<ValueType>,
+				AssignAddLazyRURQ<ValueType>, SumAssignAddApplyRURQ<ValueType>, AssignAddComposeRURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeRangeUpdateRangeQuerySumAffine =
+		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, SumCombineRURQ<ValueType>, SumDefaultValueRURQ<ValueType>,
+				AffineLazyRURQ<ValueType>, SumAffineApplyRURQ<ValueType>, AffineComposeRURQ<ValueType>>;
+
+/** Applying assign/add/affine updates to a min or max value does not depend on the length of the interval */
+template<typename ValueType> struct MinMaxAssignAddApplyRURQ {
+	ValueType operator()(ValueType val, const AssignAddLazyRURQ<ValueType>& upd, int) {
+		return (upd.assigned ? upd.assignValue : val) + upd.addValue;
+	}
+};
+
+template<typename ValueType> struct MinMaxAffineApplyRURQ {
+	ValueType operator()(ValueType val, const AffineLazyRURQ<ValueType>& upd, int) { return upd.mul * val + upd.addValue; }
+};
 
 /** Segment tree with range update range query to get min value in the given interval */
 template<typename ValueType> struct MinDefaultValueRURQ { ValueType operator()() { return std::numeric_limits<ValueType>::max(); }};
@@ -141,7 +315,13 @@ template<typename ValueType> struct MinCombineRURQ { ValueType operator()(ValueT
 
 template<typename ValueType, int MaxSize>
 using SegmentTreeRangeUpdateRangeQueryMin =
-		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, MinCombineRURQ<ValueType>, MinDefaultValueRURQ<ValueType>>;
+		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, MinCombineRURQ<ValueType>, MinDefaultValueRURQ<ValueType>,
+				AssignAddLazyRURQ<ValueType>, MinMaxAssignAddApplyRURQ<ValueType>, AssignAddComposeRURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeRangeUpdateRangeQueryMinAffine =
+		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, MinCombineRURQ<ValueType>, MinDefaultValueRURQ<ValueType>,
+				AffineLazyRURQ<ValueType>, MinMaxAffineApplyRURQ<ValueType>, AffineComposeRURQ<ValueType>>;
 
 /** Segment tree with range update range query to get max value in the given interval */
 template<typename ValueType> struct MaxDefaultValueRURQ { ValueType operator()() { return std::numeric_limits<ValueType>::min(); }};
@@ -150,4 +330,235 @@ template<typename ValueType> struct MaxCombineRURQ { ValueType operator()(ValueT
 
 template<typename ValueType, int MaxSize>
 using SegmentTreeRangeUpdateRangeQueryMax =
-		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, MaxCombineRURQ<ValueType>, MaxDefaultValueRURQ<ValueType>>;
+		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, MaxCombineRURQ<ValueType>, MaxDefaultValueRURQ<ValueType>,
+				AssignAddLazyRURQ<ValueType>, MinMaxAssignAddApplyRURQ<ValueType>, AssignAddComposeRURQ<ValueType>>;
+
+template<typename ValueType, int MaxSize>
+using SegmentTreeRangeUpdateRangeQueryMaxAffine =
+		SegmentTreeRangeUpdateRangeQuery<ValueType, MaxSize, MaxCombineRURQ<ValueType>, MaxDefaultValueRURQ<ValueType>,
+				AffineLazyRURQ<ValueType>, MinMaxAffineApplyRURQ<ValueType>, AffineComposeRURQ<ValueType>>;
+
+/**
+ * \brief Defines a class for a Segment Tree Beats, supporting range chmin (a[i] = min(a[i], x)), range chmax
+ *        (a[i] = max(a[i], x)) and range add, with range sum/min/max queries.
+ *        Every node keeps its maximum, strict second maximum and amount of maximums (and the same for minimums), so a
+ *        chmin only has to be pushed down while it changes more than one distinct value of the node.
+ *        Time complexity: O(log^2(n)) amortized per update, O(log(n)) per query.
+ *        State: untested.
+ *        Ref: https://codeforces.com/blog/entry/57319
+ *
+ * \tparam ValueType Type of the elements (also used for the sums, so use a wide enough type).
+ * \tparam MaxSize Maximum number of elements.
+ */
+template<typename ValueType, int MaxSize>
+class SegmentTreeBeats {
+private:
+	int n;
+	ValueType sum[MaxSize * 4], lazyAdd[MaxSize * 4];
+	ValueType max1[MaxSize * 4], max2[MaxSize * 4], min1[MaxSize * 4], min2[MaxSize * 4];
+	int maxCount[MaxSize * 4], minCount[MaxSize * 4];
+
+	static constexpr ValueType lowest = std::numeric_limits<ValueType>::lowest();
+	static constexpr ValueType highest = std::numeric_limits<ValueType>::max();
+
+	void setLeaf(int v, ValueType val) {
+		sum[v] = max1[v] = min1[v] = val;
+		max2[v] = lowest;
+		min2[v] = highest;
+		maxCount[v] = minCount[v] = 1;
+		lazyAdd[v] = 0;
+	}
+
+	void pull(int v) {
+		int l = v * 2, r = v * 2 + 1;
+		sum[v] = sum[l] + sum[r];
+		lazyAdd[v] = 0;
+
+		if (max1[l] == max1[r]) {
+			max1[v] = max1[l];
+			max2[v] = std::max(max2[l], max2[r]);
+			maxCount[v] = maxCount[l] + maxCount[r];
+		} else if (max1[l] > max1[r]) {
+			max1[v] = max1[l];
+			max2[v] = std::max(max2[l], max1[r]);
+			maxCount[v] = maxCount[l];
+		} else {
+			max1[v] = max1[r];
+			max2[v] = std::max(max1[l], max2[r]);
+			maxCount[v] = maxCount[r];
+		}
+
+		if (min1[l] == min1[r]) {
+			min1[v] = min1[l];
+			min2[v] = std::min(min2[l], min2[r]);
+			minCount[v] = minCount[l] + minCount[r];
+		} else if (min1[l] < min1[r]) {
+			min1[v] = min1[l];
+			min2[v] = std::min(min2[l], min1[r]);
+			minCount[v] = minCount[l];
+		} else {
+			min1[v] = min1[r];
+			min2[v] = std::min(min1[l], min2[r]);
+			minCount[v] = minCount[r];
+		}
+	}
+
+	void applyAdd(int v, int len, ValueType val) {
+		sum[v] += val * len;
+		max1[v] += val;
+		if (max2[v] != lowest) max2[v] += val;
+		min1[v] += val;
+		if (min2[v] != highest) min2[v] += val;
+		lazyAdd[v] += val;
+	}
+
+	// Requires max2[v] < val
+	void applyChmin(int v, ValueType val) {
+		if (max1[v] <= val) return;
+		sum[v] -= (max1[v] - val) * maxCount[v];
+		if (min1[v] == max1[v]) min1[v] = val;
+		else if (min2[v] == max1[v]) min2[v] = val;
+		max1[v] = val;
+	}
+
+	// Requires min2[v] > val
+	void applyChmax(int v, ValueType val) {
+		if (min1[v] >= val) return;
+		sum[v] += (val - min1[v]) * minCount[v];
+		if (max1[v] == min1[v]) max1[v] = val;
+		else if (max2[v] == min1[v]) max2[v] = val;
+		min1[v] = val;
+	}
+
+	void push(int v, int tl, int tr) {
+		int tm = (tl + tr) / 2;
+		if (lazyAdd[v] != 0) {
+			applyAdd(v * 2, tm - tl + 1, lazyAdd[v]);
+			applyAdd(v * 2 + 1, tr - tm, lazyAdd[v]);
+			lazyAdd[v] = 0;
+		}
+		applyChmin(v * 2, max1[v]);
+		applyChmin(v * 2 + 1, max1[v]);
+		applyChmax(v * 2, min1[v]);
+		applyChmax(v * 2 + 1, min1[v]);
+	}
+
+	void build(ValueType arr[], int v, int tl, int tr) {
+		if (tl == tr) setLeaf(v, arr[tl]);
+		else {
+			int tm = (tl + tr) / 2;
+			build(arr, v * 2, tl, tm);
+			build(arr, v * 2 + 1, tm + 1, tr);
+			pull(v);
+		}
+	}
+
+	void build(int v, int tl, int tr, ValueType val) {
+		if (tl == tr) setLeaf(v, val);
+		else {
+			int tm = (tl + tr) / 2;
+			build(v * 2, tl, tm, val);
+			build(v * 2 + 1, tm + 1, tr, val);
+			pull(v);
+		}
+	}
+
+	void chmin(int v, int tl, int tr, int l, int r, ValueType val) {
+		if (l > r || max1[v] <= val) return;
+		if (l == tl && r == tr && max2[v] < val) {
+			applyChmin(v, val);
+			return;
+		}
+		push(v, tl, tr);
+		int tm = (tl + tr) / 2;
+		chmin(v * 2, tl, tm, l, std::min(r, tm), val);
+		chmin(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, val);
+		pull(v);
+	}
+
+	void chmax(int v, int tl, int tr, int l, int r, ValueType val) {
+		if (l > r || min1[v] >= val) return;
+		if (l == tl && r == tr && min2[v] > val) {
+			applyChmax(v, val);
+			return;
+		}
+		push(v, tl, tr);
+		int tm = (tl + tr) / 2;
+		chmax(v * 2, tl, tm, l, std::min(r, tm), val);
+		chmax(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, val);
+		pull(v);
+	}
+
+	void add(int v, int tl, int tr, int l, int r, ValueType val) {
+		if (l > r) return;
+		if (l == tl && r == tr) {
+			applyAdd(v, tr - tl + 1, val);
+			return;
+		}
+		push(v, tl, tr);
+		int tm = (tl + tr) / 2;
+		add(v * 2, tl, tm, l, std::min(r, tm), val);
+		add(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r, val);
+		pull(v);
+	}
+
+	ValueType querySum(int v, int tl, int tr, int l, int r) {
+		if (l > r) return 0;
+		if (l == tl && r == tr) return sum[v];
+		push(v, tl, tr);
+		int tm = (tl + tr) / 2;
+		return querySum(v * 2, tl, tm, l, std::min(r, tm)) + querySum(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r);
+	}
+
+	ValueType queryMin(int v, int tl, int tr, int l, int r) {
+		if (l > r) return highest;
+		if (l == tl && r == tr) return min1[v];
+		push(v, tl, tr);
+		int tm = (tl + tr) / 2;
+		return std::min(queryMin(v * 2, tl, tm, l, std::min(r, tm)), queryMin(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r));
+	}
+
+	ValueType queryMax(int v, int tl, int tr, int l, int r) {
+		if (l > r) return lowest;
+		if (l == tl && r == tr) return max1[v];
+		push(v, tl, tr);
+		int tm = (tl + tr) / 2;
+		return std::max(queryMax(v * 2, tl, tm, l, std::min(r, tm)), queryMax(v * 2 + 1, tm + 1, tr, std::max(l, tm + 1), r));
+	}
+
+public:
+
+	void build(int size, ValueType val) {
+		n = size;
+		build(1, 0, size - 1, val);
+	}
+
+	void build(int size, ValueType* arr) {
+		n = size;
+		build(arr, 1, 0, size - 1);
+	}
+
+	void chmin(int l, int r, ValueType val) {
+		chmin(1, 0, n - 1, l, r, val);
+	}
+
+	void chmax(int l, int r, ValueType val) {
+		chmax(1, 0, n - 1, l, r, val);
+	}
+
+	void add(int l, int r, ValueType val) {
+		add(1, 0, n - 1, l, r, val);
+	}
+
+	ValueType querySum(int l, int r) {
+		return querySum(1, 0, n - 1, l, r);
+	}
+
+	ValueType queryMin(int l, int r) {
+		return queryMin(1, 0, n - 1, l, r);
+	}
+
+	ValueType queryMax(int l, int r) {
+		return queryMax(1, 0, n - 1, l, r);
+	}
+};
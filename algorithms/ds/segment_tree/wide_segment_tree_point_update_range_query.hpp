@@ -0,0 +1,101 @@
+
+/**
+ * \brief Defines a class for a wide (B-ary) Segment Tree for range sum queries, with B = 64 / sizeof(ValueType)
+ *        (16 for 32-bit and 8 for 64-bit integers), so every node is exactly one 64-byte aligned cache line.
+ *        Key j of a node holds the sum of its children 0..j-1, so a prefix sum reads one key per layer (log_B(n)
+ *        dependent loads instead of log_2(n)), and an update adds the delta to a masked suffix of one node per layer.
+ *        The masked add is a plain loop (no intrinsics) with a fixed trip count and no branches, which the compiler
+ *        vectorizes: GCC -O2 -mavx2 does a node with two compare/add/blend steps on ymm registers (SSE without -mavx2).
+ *        Queries don't need SIMD, they read a single key per layer.
+ *        Best suited for read-heavy workloads (see wide_segment_tree_point_update_range_query_bench.cpp).
+ *        State: untested.
+ *        Ref: https://en.algorithmica.org/hpc/data-structures/segment-trees/#wide-segment-trees
+ *
+ * \details Build: O(n)
+ *          Query: O(log_B(n))
+ *          Update: O(log_B(n)) vector operations
+ *
+ * \tparam ValueType Type of the elements, it must be an integral type (sums are computed with it).
+ */
+template<typename ValueType>
+class WideSegmentTreePointUpdateRangeQuerySum {
+private:
+	static_assert(std::is_integral<ValueType>::value, "WideSegmentTreePointUpdateRangeQuerySum requires an integral type");
+
+	static constexpr int B = 64 / sizeof(ValueType);
+	static constexpr int LogB = B == 16 ? 4 : B == 8 ? 3 : B == 32 ? 5 : 6;
+
+	struct alignas(64) Node {
+		ValueType key[B];
+	};
+
+	int n, height;
+	std::vector<Node> nodes;
+	std::vector<int> offset; // offset[h]: first node of the layer h (h = 0 is the bottom layer)
+
+	/**
+	 * Index in the layer h of the node holding the position k. The shift is 64-bit, since for the top layer it can reach
+	 * 32 (e.g. 32-bit values with n >= 2^28).
+	 */
+	static int nodeIndex(int k, int h) {
+		return (int)((long long)k >> (LogB * (h + 1)));
+	}
+
+	ValueType prefixSum(int k) {
+		ValueType res = 0;
+		for (int h = 0; h < height; h++)
+			res += nodes[offset[h] + nodeIndex(k, h)].key[(k >> (LogB * h)) & (B - 1)];
+		return res;
+	}
+
+	void init(int size) {
+		n = size;
+		height = 1;
+		while ((long long)1 << (LogB * height) <= n) height++;
+		offset.assign(height, 0);
+		int total = 0;
+		// Upper layers first, so the hottest nodes are contiguous
+		for (int h = height - 1; h >= 0; h--) {
+			offset[h] = total;
+			total += nodeIndex(n, h) + 1;
+		}
+		nodes.assign(total, Node{});
+	}
+
+public:
+
+	void build(int size) {
+		init(size);
+	}
+
+	void build(int size, ValueType* arr) {
+		init(size);
+		std::vector<ValueType> sums(arr, arr + size), next;
+		for (int h = 0; h < height; h++) {
+			next.assign((sums.size() + B - 1) >> LogB, 0);
+			for (size_t i = 0; i < sums.size(); i++) {
+				Node& node = nodes[offset[h] + (i >> LogB)];
+				ValueType& total = next[i >> LogB];
+				if ((i & (B - 1)) + 1 < B) node.key[(i & (B - 1)) + 1] = total + sums[i];
+				total += sums[i];
+			}
+			sums.swap(next);
+		}
+	}
+
+	ValueType query(int l, int r) {
+		return prefixSum(r + 1) - prefixSum(l);
+	}
+
+	void add(int idx, ValueType delta) {
+		for (int h = 0; h < height; h++) {
+			ValueType* key = nodes[offset[h] + nodeIndex(idx, h)].key;
+			int j = (idx >> (LogB * h)) & (B - 1);
+			for (int t = 0; t < B; t++) key[t] += t > j ? delta : 0;
+		}
+	}
+
+	void update(int idx, ValueType val) {
+		add(idx, val - query(idx, idx));
+	}
+};
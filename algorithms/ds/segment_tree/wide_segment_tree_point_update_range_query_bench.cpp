@@ -0,0 +1,70 @@
+#include <bits/stdc++.h>
+
+using namespace std;
+
+#include "segment_tree_point_update_range_query.hpp"
+#include "wide_segment_tree_point_update_range_query.hpp"
+
+/**
+ * Benchmark of WideSegmentTreePointUpdateRangeQuerySum against the binary SegmentTreePointUpdateRangeQuerySum, with
+ * random range sum queries (the read-heavy workload) and random point updates (the vectorized masked adds), for every
+ * given n (1e6, 1e7 and 1e8 by default). Both trees use long long, since the sums of large ranges don't fit in an
+ * int. The binary tree needs up to 32 * n bytes, about 3.2 GB for n = 1e8.
+ * Usage: wide_segment_tree_point_update_range_query_bench [operations] [n...]
+ * Build it with optimizations and AVX2 for the vectorized updates (e.g. g++ -std=c++17 -O2 -mavx2).
+ */
+
+const int MaxN = 100000000;
+
+// Over 2 GB, too big for a static array. new without () doesn't zero it, so only the nodes used are touched.
+auto* binaryTree = new SegmentTreePointUpdateRangeQuerySum<long long, MaxN>;
+WideSegmentTreePointUpdateRangeQuerySum<long long> wideTree;
+
+template<typename Func>
+double measure(Func func) {
+	auto start = chrono::steady_clock::now();
+	func();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template<typename Tree>
+long long runQueries(Tree& tree, const vector<pair<int, int>>& ranges) {
+	long long checksum = 0;
+	for (const auto& [l, r] : ranges) checksum += tree.query(l, r);
+	return checksum;
+}
+
+int main(int argc, char* argv[]) {
+	int operations = argc > 1 ? atoi(argv[1]) : 5000000;
+	vector<int> sizes;
+	for (int i = 2; i < argc; i++) sizes.push_back(min(atoi(argv[i]), MaxN));
+	if (sizes.empty()) sizes = { 1000000, 10000000, 100000000 };
+
+	mt19937 rng(12345);
+	for (int n : sizes) {
+		vector<long long> arr(n);
+		for (long long& x : arr) x = rng() % 1000;
+		vector<pair<int, int>> ranges(operations);
+		vector<pair<int, int>> updates(operations);
+		for (auto& [l, r] : ranges) {
+			l = rng() % n, r = rng() % n;
+			if (l > r) swap(l, r);
+		}
+		for (auto& [idx, val] : updates) idx = rng() % n, val = rng() % 1000;
+
+		binaryTree->build(n, arr.data());
+		wideTree.build(n, arr.data());
+		long long checksumBinary = 0, checksumWide = 0;
+		double queryBinary = measure([&]() { checksumBinary = runQueries(*binaryTree, ranges); });
+		double queryWide = measure([&]() { checksumWide = runQueries(wideTree, ranges); });
+		double updateBinary = measure([&]() { for (const auto& [idx, val] : updates) binaryTree->update(idx, val); });
+		double updateWide = measure([&]() { for (const auto& [idx, val] : updates) wideTree.update(idx, val); });
+		if (runQueries(*binaryTree, ranges) != runQueries(wideTree, ranges)) checksumWide = ~checksumBinary;
+
+		printf("n = %d: query binary %.0f ns, wide %.0f ns (%.2fx); update binary %.0f ns, wide %.0f ns (%.2fx)%s\n", n,
+		       queryBinary * 1e9 / operations, queryWide * 1e9 / operations, queryBinary / queryWide,
+		       updateBinary * 1e9 / operations, updateWide * 1e9 / operations, updateBinary / updateWide,
+		       checksumBinary == checksumWide ? "" : " ANSWERS DIFFER");
+	}
+	return 0;
+}
@@ -17,11 +17,15 @@
 template<typename ValueType, int MaxSize, int MaxSizeLog, typename ElementCompare = std::less<ValueType>, typename PositionCompare = std::less<int>>
 class SparseTableRMQ {
 private:
+	static constexpr int ParallelMinSize = 1 << 16; // minimum number of elements of a level for each thread
+	static constexpr int Lanes = 16;
+
 	int n, k;
 	ElementCompare elementCompare;
 	PositionCompare positionCompare;
-	ValueType st[MaxSizeLog + 1][MaxSize];
+	int st[MaxSizeLog + 1][MaxSize];
 	ValueType arr[MaxSize];
+	std::vector<ValueType> levelValues[2]; // levelValues[i & 1][j]: arr[st[i][j]], only for the last two levels of the build
 
 #if __cplusplus >= 202002L
 	int log2_floor(ValueType i) {
@@ -39,15 +43,63 @@ private:
 	// Replace std::min with std::max if you need the rightmost index instead of the leftmost
 	int calcIndex(int i, int j) {
 		if (elementCompare(arr[i], arr[j])) return i;
-		if (!elementCompare(arr[i], arr[j])) return j;
+		if (elementCompare(arr[j], arr[i])) return j;
 		return positionCompare(i, j) ? i : j;
 	}
 
-	void calcSparseTable() {
+	/**
+	 * Chooses between the intervals starting at indexA/valueA and the ones starting at indexB/valueB, for Count
+	 * consecutive positions. The values are read from contiguous buffers instead of arr[index], the choice has no
+	 * branches, and the trip count is fixed, so it is vectorized (compare and blend of values and indexes) for
+	 * arithmetic types and the std comparators. The pointers are restrict so the compiler doesn't need alias checks.
+	 */
+	template<int Count>
+	static void calcChunk(const int* __restrict indexA, const int* __restrict indexB, const ValueType* __restrict valueA,
+	                      const ValueType* __restrict valueB, int* __restrict curIndex, ValueType* __restrict curValue,
+	                      ElementCompare elementCompare, PositionCompare positionCompare) {
+		for (int t = 0; t < Count; t++) {
+			int ia = indexA[t], ib = indexB[t];
+			ValueType a = valueA[t], b = valueB[t];
+			bool takeB = elementCompare(b, a) | (!elementCompare(a, b) & positionCompare(ib, ia));
+			curIndex[t] = takeB ? ib : ia;
+			curValue[t] = takeB ? b : a;
+		}
+	}
+
+	/** Calculates st[i][from..to) from the level i - 1. */
+	void calcLevel(int i, int from, int to) {
+		const int* prevIndex = st[i - 1];
+		const ValueType* prevValue = levelValues[(i - 1) & 1].data();
+		int* curIndex = st[i];
+		ValueType* curValue = levelValues[i & 1].data();
+		int half = 1 << (i - 1), j = from;
+		for (; j + Lanes <= to; j += Lanes)
+			calcChunk<Lanes>(prevIndex + j, prevIndex + j + half, prevValue + j, prevValue + j + half, curIndex + j, curValue + j,
+			                 elementCompare, positionCompare);
+		for (; j < to; j++)
+			calcChunk<1>(prevIndex + j, prevIndex + j + half, prevValue + j, prevValue + j + half, curIndex + j, curValue + j,
+			             elementCompare, positionCompare);
+	}
+
+	void calcSparseTable(int threads = 1) {
 		for (int i = 0; i < n; i++) st[0][i] = i;
-		for (int i = 1; i <= k; i++)
-			for (int j = 0; j + (1 << i) <= n; j++)
-				st[i][j] = calcIndex(st[i - 1][j], st[i - 1][j + (1 << (i - 1))]);
+		levelValues[0].assign(arr, arr + n);
+		levelValues[1].resize(n);
+		for (int i = 1; i <= k; i++) {
+			int count = n - (1 << i) + 1;
+			int parts = std::max(1, std::min(threads, count / ParallelMinSize));
+			if (parts == 1) {
+				calcLevel(i, 0, count);
+				continue;
+			}
+			// Each level depends on the previous one, so the threads split every level
+			std::vector<std::future<void>> tasks;
+			for (int t = 0; t < parts; t++) {
+				int from = (int)((long long)count * t / parts), to = (int)((long long)count * (t + 1) / parts);
+				tasks.push_back(std::async(std::launch::async, [=]() { calcLevel(i, from, to); }));
+			}
+			for (auto& task : tasks) task.get();
+		}
 	}
 
 public:
@@ -74,6 +126,14 @@ public:
 		setNewArray(newArray, newArray + size);
 	}
 
+	/** Same as setNewArray(newArray, size) splitting every level of the build between the given number of threads. */
+	void setNewArray(ValueType* newArray, int size, int threads) {
+		std::copy(newArray, newArray + size, arr);
+		n = size;
+		k = log2_floor(n);
+		calcSparseTable(threads);
+	}
+
 	int queryIndex(int l, int r) {
 		auto i = log2_floor(r - l + 1);
 		return calcIndex(st[i][l], st[i][r - (1 << i) + 1]);
@@ -83,3 +143,114 @@ public:
 		return arr[queryIndex(l, r)];
 	}
 };
+
+/**
+ * \brief Defines a class for a range min/max query with O(1) queries and O(n) words of memory.
+ *        The array is split in blocks of 64 elements. For every position r, a 64 bit mask marks the positions p of its
+ *        block (p <= r) whose element is chosen over every element in (p, r] (the monotonic stack of the block after
+ *        adding r), so the answer inside a block for [l, r] is the lowest marked position not before l. A sparse table
+ *        over the blocks answers the whole blocks in between. The chosen element follows the same rules as in
+ *        SparseTableRMQ: ElementCompare first, and PositionCompare on ties (the leftmost one by default).
+ *        It uses sizeof(ValueType) + 8 bytes per element plus about n / 64 * log2(n / 64) indexes, instead of the
+ *        (log2(n) + 1) * n indexes of SparseTableRMQ.
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/sparse-table.html
+ *             https://codeforces.com/blog/entry/78931 (O(1) RMQ with O(n) memory, using bitmasks)
+ *
+ * \details Build: O(n)
+ *          Query: O(1)
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam ElementCompare Comparator function to use (std::less by default, for a range minimum query).
+ * \tparam PositionCompare Comparator function for the indexes of the elements (std::less by default, to choose the leftmost value).
+ */
+template<typename ValueType, typename ElementCompare = std::less<ValueType>, typename PositionCompare = std::less<int>>
+class LinearSparseTableRMQ {
+private:
+	static constexpr int BlockLog = 6;
+	static constexpr int BlockSize = 1 << BlockLog;
+
+	int n, blocks;
+	ElementCompare elementCompare;
+	PositionCompare positionCompare;
+	std::vector<ValueType> arr;
+	std::vector<unsigned long long> masks; // masks[r]: bit p is set if arr[block(r) + p] is chosen over (block(r) + p, r]
+	std::vector<int> st;                   // st[i * blocks + b]: index chosen in the blocks [b, b + 2^i)
+
+	static int log2Floor(int i) {
+		return 31 - __builtin_clz(i);
+	}
+
+	/** True if the element at i is chosen over the one at j. */
+	bool better(int i, int j) {
+		if (elementCompare(arr[i], arr[j])) return true;
+		if (elementCompare(arr[j], arr[i])) return false;
+		return positionCompare(i, j);
+	}
+
+	int calcIndex(int i, int j) {
+		return better(i, j) ? i : j;
+	}
+
+	int queryBlock(int l, int r) {
+		return (r & ~(BlockSize - 1)) + __builtin_ctzll(masks[r] & (~0ULL << (l & (BlockSize - 1))));
+	}
+
+	void calcTables() {
+		masks.resize(n);
+		for (int b = 0; b * BlockSize < n; b++) {
+			unsigned long long stack = 0;
+			for (int i = b * BlockSize; i < std::min(n, (b + 1) * BlockSize); i++) {
+				while (stack && !better((b << BlockLog) + 63 - __builtin_clzll(stack), i))
+					stack ^= 1ULL << (63 - __builtin_clzll(stack));
+				stack |= 1ULL << (i & (BlockSize - 1));
+				masks[i] = stack;
+			}
+		}
+
+		blocks = (n + BlockSize - 1) >> BlockLog;
+		int levels = log2Floor(blocks) + 1;
+		st.resize((size_t)levels * blocks);
+		for (int b = 0; b < blocks; b++) st[b] = queryBlock(b << BlockLog, std::min(n, (b + 1) << BlockLog) - 1);
+		for (int i = 1; i < levels; i++)
+			for (int b = 0; b + (1 << i) <= blocks; b++)
+				st[(size_t)i * blocks + b] = calcIndex(st[(size_t)(i - 1) * blocks + b], st[(size_t)(i - 1) * blocks + b + (1 << (i - 1))]);
+	}
+
+public:
+
+	void setNewArray(ValueType* begin, ValueType* end) {
+		arr.assign(begin, end);
+		n = (int)arr.size();
+		calcTables();
+	}
+
+	void setNewArray(typename std::vector<ValueType>::iterator begin, typename std::vector<ValueType>::iterator end) {
+		arr.assign(begin, end);
+		n = (int)arr.size();
+		calcTables();
+	}
+
+	void setNewArray(std::vector<ValueType>& newArray) {
+		setNewArray(newArray.begin(), newArray.end());
+	}
+
+	void setNewArray(ValueType* newArray, int size) {
+		setNewArray(newArray, newArray + size);
+	}
+
+	int queryIndex(int l, int r) {
+		int bl = l >> BlockLog, br = r >> BlockLog;
+		if (bl == br) return queryBlock(l, r);
+		int res = calcIndex(queryBlock(l, (bl << BlockLog) + BlockSize - 1), queryBlock(br << BlockLog, r));
+		if (bl + 1 < br) {
+			int i = log2Floor(br - bl - 1);
+			res = calcIndex(res, calcIndex(st[(size_t)i * blocks + bl + 1], st[(size_t)i * blocks + br - (1 << i)]));
+		}
+		return res;
+	}
+
+	ValueType queryValue(int l, int r) {
+		return arr[queryIndex(l, r)];
+	}
+};
@@ -0,0 +1,78 @@
+#include <bits/stdc++.h>
+
+using namespace std;
+
+#include "sparse_table.hpp"
+
+/**
+ * Benchmark of the SparseTableRMQ build (vectorized levels, optionally split between threads) against the scalar
+ * build it replaced, which filled every level calling calcIndex (two data-dependent branches per element). Every
+ * round rebuilds the table over a fresh random array, as in a batch of rebuilds. The throughput counts the bytes of
+ * the index table written, (floor(log2(n)) + 1) * n ints.
+ * Usage: sparse_table_bench [n] [rounds] [max threads]
+ * Build it with optimizations (e.g. g++ -std=c++17 -O2 -pthread, optionally -mavx2).
+ */
+
+const int MaxN = 1 << 22;
+const int MaxLog = 22;
+
+SparseTableRMQ<int, MaxN, MaxLog> sparseTable;
+
+template<typename Func>
+double measure(Func func) {
+	auto start = chrono::steady_clock::now();
+	func();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/** The scalar build: st[i * n + j] is the index of the minimum of [j, j + 2^i), the leftmost one on ties. */
+void scalarBuild(const vector<int>& arr, vector<int>& st) {
+	int n = arr.size(), k = 31 - __builtin_clz(n);
+	auto calcIndex = [&](int i, int j) {
+		if (arr[i] < arr[j]) return i;
+		if (arr[j] < arr[i]) return j;
+		return i < j ? i : j;
+	};
+	st.resize((size_t)(k + 1) * n);
+	for (int j = 0; j < n; j++) st[j] = j;
+	for (int i = 1; i <= k; i++)
+		for (int j = 0; j + (1 << i) <= n; j++)
+			st[(size_t)i * n + j] = calcIndex(st[(size_t)(i - 1) * n + j], st[(size_t)(i - 1) * n + j + (1 << (i - 1))]);
+}
+
+int main(int argc, char* argv[]) {
+	int n = argc > 1 ? min(atoi(argv[1]), MaxN) : MaxN;
+	int rounds = argc > 2 ? atoi(argv[2]) : 5;
+	int maxThreads = argc > 3 ? atoi(argv[3]) : max(1, (int)thread::hardware_concurrency());
+	int k = 31 - __builtin_clz(n);
+	double gigabytes = (double)(k + 1) * n * sizeof(int) * rounds / 1e9;
+
+	mt19937 rng(12345);
+	vector<vector<int>> arrays(rounds, vector<int>(n));
+	for (auto& arr : arrays)
+		for (int& x : arr) x = rng() % 1000000;
+	vector<int> st;
+	scalarBuild(arrays[0], st); // warm up the memory of both tables
+	sparseTable.setNewArray(arrays[0].data(), n);
+
+	double scalar = measure([&]() { for (auto& arr : arrays) scalarBuild(arr, st); });
+	double vectorized = measure([&]() { for (auto& arr : arrays) sparseTable.setNewArray(arr.data(), n); });
+	double parallel = measure([&]() { for (auto& arr : arrays) sparseTable.setNewArray(arr.data(), n, maxThreads); });
+
+	// The last build of both is over the last array, they must choose the same indexes
+	bool same = true;
+	for (int q = 0; q < 100000 && same; q++) {
+		int l = rng() % n, r = rng() % n;
+		if (l > r) swap(l, r);
+		int i = 31 - __builtin_clz(r - l + 1), a = st[(size_t)i * n + l], b = st[(size_t)i * n + r - (1 << i) + 1];
+		int expected = arrays.back()[a] < arrays.back()[b] ? a : arrays.back()[b] < arrays.back()[a] ? b : min(a, b);
+		same = sparseTable.queryIndex(l, r) == expected;
+	}
+
+	printf("n = %d, %d rounds, %.2f GB of index table per build type\n", n, rounds, gigabytes);
+	printf("scalar:                %.3fs, %.2f GB/s\n", scalar, gigabytes / scalar);
+	printf("vectorized:            %.3fs, %.2f GB/s (%.2fx)\n", vectorized, gigabytes / vectorized, scalar / vectorized);
+	printf("vectorized, %d threads: %.3fs, %.2f GB/s (%.2fx)%s\n", maxThreads, parallel, gigabytes / parallel, scalar / parallel,
+	       same ? "" : " ANSWERS DIFFER");
+	return 0;
+}
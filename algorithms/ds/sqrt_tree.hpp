@@ -1,4 +1,25 @@
 
+/**
+ * Calls buildBlocks(from, to) for the blocks [0, blocks) of the layer 0 of a sqrt tree of n elements. The blocks are
+ * independent, so they are split in up to threads contiguous parts built in parallel (arrays with less than
+ * ParallelMinSize elements per thread are built by the calling thread).
+ */
+template<typename BuildBlocks>
+void buildSqrtTreeBlocks(int n, int blocks, int threads, BuildBlocks buildBlocks) {
+	const int ParallelMinSize = 1 << 16;
+	int parts = std::max(1, std::min(threads, n / ParallelMinSize));
+	if (parts == 1) {
+		buildBlocks(0, blocks);
+		return;
+	}
+	std::vector<std::future<void>> tasks;
+	for (int t = 0; t < parts; t++) {
+		int from = (int)((long long)blocks * t / parts), to = (int)((long long)blocks * (t + 1) / parts);
+		tasks.push_back(std::async(std::launch::async, [=]() { buildBlocks(from, to); }));
+	}
+	for (auto& task : tasks) task.get();
+}
+
 /**
  * \brief Defines a class for a Sqrt Tree.
  *        State: tested.
@@ -68,6 +89,16 @@ private:
 		else buildBetween(layer, lBound, rBound, betweenOffs);
 	}
 
+	/** Builds the blocks of the layer 0 in [from, to), with their lower layers. */
+	void buildBlocks(int from, int to) {
+		int bSzLog = (lg + 1) >> 1;
+		for (int b = from; b < to; b++) {
+			int l = b << bSzLog, r = std::min(l + (1 << bSzLog), n);
+			buildBlock(0, l, r);
+			build(1, l, r, 0);
+		}
+	}
+
 	void update(int layer, int lBound, int rBound, int betweenOffs, int x) {
 		if (layer >= (int)layers.size()) return;
 		int bSzLog = (layers[layer] + 1) >> 1;
@@ -112,6 +143,14 @@ public:
 	}
 
 	void build(const std::vector<ValueType>& a, std::function<ValueType(ValueType, ValueType)> op) {
+		build(a, op, 1);
+	}
+
+	/**
+	 * Same as build(a, op) splitting the blocks of the layer 0 between the given number of threads (e.g.
+	 * std::thread::hardware_concurrency()). op must be safe to call concurrently.
+	 */
+	void build(const std::vector<ValueType>& a, std::function<ValueType(ValueType, ValueType)> op, int threads) {
 		n = (int)a.size();
 		lg = log2Up(n);
 		v = a;
@@ -141,6 +180,396 @@ public:
 		for (int i = 0; i < suf.size(); i++) suf[i].resize(n + indexSz);
 		between.resize(betweenLayers);
 		for (int i = 0; i < between.size(); i++) between[i].resize((1 << lg) + bSz, 0);
-		build(0, 0, n, 0);
+		if (layers.empty()) return;
+		buildSqrtTreeBlocks(n, indexSz, threads, [this](int from, int to) { buildBlocks(from, to); });
+		buildBetweenZero();
 	}
 };
+
+/**
+ * \brief Defines a class for a Sqrt Tree with the operation given as a functor, so every combine is inlined.
+ *        Same layout as SqrtTree, but each of pref, suf and between is a single contiguous array (layer by layer), and
+ *        the values filling the index of the layer 0 are the identity of the operation instead of a hardcoded 1.
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/sqrt-tree.html
+ *             https://codeforces.com/blog/entry/57046
+ *
+ * \details Build: O(n * log(log(n)))
+ *          Query: O(1)
+ *          Update: O(sqrt(n))
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam CombineFunc Associative function to combine intervals
+ *         (e.g. struct SumCombine { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};).
+ * \tparam DefaultValueFunc Function returning the identity of CombineFunc, also returned for an undefined interval (l > r)
+ *         (e.g. struct SumDefaultValue { ValueType operator()() { return 0; }};).
+ */
+template<typename ValueType, typename CombineFunc, typename DefaultValueFunc>
+class FlatSqrtTree {
+protected:
+	int n, lg, indexSz, width, betweenWidth, blockLog;
+	std::vector<ValueType> v;
+	std::vector<int> layers, onLayer;
+	std::vector<ValueType> pref, suf; // pref[layer * width + i]
+	std::vector<ValueType> between;   // between[(layer - 1) * betweenWidth + i]
+	CombineFunc combine;
+	DefaultValueFunc defaultValueFunc;
+
+	inline int log2Up(int val) {
+		int res = 0;
+		while ((1 << res) < val) res++;
+		return res;
+	}
+
+	inline void buildBlock(int layer, int l, int r) {
+		ValueType* p = pref.data() + (size_t)layer * width;
+		ValueType* s = suf.data() + (size_t)layer * width;
+		p[l] = v[l];
+		for (int i = l + 1; i < r; i++) p[i] = combine(p[i - 1], v[i]);
+		s[r - 1] = v[r - 1];
+		for (int i = r - 2; i >= l; i--) s[i] = combine(v[i], s[i + 1]);
+	}
+
+	inline void buildBetween(int layer, int lBound, int rBound, int betweenOffs) {
+		int bSzLog = (layers[layer] + 1) >> 1;
+		int bCntLog = layers[layer] >> 1;
+		int bSz = 1 << bSzLog;
+		int bCnt = (rBound - lBound + bSz - 1) >> bSzLog;
+		const ValueType* s = suf.data() + (size_t)layer * width;
+		ValueType* b = between.data() + (size_t)(layer - 1) * betweenWidth + betweenOffs + lBound;
+		for (int i = 0; i < bCnt; i++) {
+			ValueType ans = s[lBound + (i << bSzLog)];
+			b[(i << bCntLog) + i] = ans;
+			for (int j = i + 1; j < bCnt; j++) {
+				ans = combine(ans, s[lBound + (j << bSzLog)]);
+				b[(i << bCntLog) + j] = ans;
+			}
+		}
+	}
+
+	/** Builds the index over the blocks of the layer 0 from their values v[n, n + indexSz). */
+	void buildIndex() {
+		build(1, n, n + indexSz, (1 << lg) - n);
+	}
+
+	inline void buildBetweenZero() {
+		for (int i = 0; i < indexSz; i++) v[n + i] = suf[i << blockLog];
+		buildIndex();
+	}
+
+	inline void updateBetweenZero(int bid) {
+		v[n + bid] = suf[bid << blockLog];
+		update(1, n, n + indexSz, (1 << lg) - n, n + bid);
+	}
+
+	void build(int layer, int lBound, int rBound, int betweenOffs) {
+		if (layer >= (int)layers.size()) return;
+		int bSz = 1 << ((layers[layer] + 1) >> 1);
+		for (int l = lBound; l < rBound; l += bSz) {
+			int r = std::min(l + bSz, rBound);
+			buildBlock(layer, l, r);
+			build(layer + 1, l, r, betweenOffs);
+		}
+		if (layer == 0) buildBetweenZero();
+		else buildBetween(layer, lBound, rBound, betweenOffs);
+	}
+
+	/** Builds the block b of the layer 0 with its lower layers (not its value in the index). */
+	void buildBlockZero(int b) {
+		int l = b << blockLog, r = std::min(l + (1 << blockLog), n);
+		buildBlock(0, l, r);
+		build(1, l, r, 0);
+	}
+
+	/** Builds the blocks of the layer 0 in [from, to), with their lower layers. */
+	void buildBlocks(int from, int to) {
+		for (int b = from; b < to; b++) buildBlockZero(b);
+	}
+
+	/** The blocks of the layer 0 are split between the threads, and then the index over them is built. */
+	void buildLayerZero(int threads) {
+		if (layers.empty()) return;
+		buildSqrtTreeBlocks(n, indexSz, threads, [this](int from, int to) { buildBlocks(from, to); });
+		buildBetweenZero();
+	}
+
+	void update(int layer, int lBound, int rBound, int betweenOffs, int x) {
+		if (layer >= (int)layers.size()) return;
+		int bSzLog = (layers[layer] + 1) >> 1;
+		int bSz = 1 << bSzLog;
+		int blockIdx = (x - lBound) >> bSzLog;
+		int l = lBound + (blockIdx << bSzLog);
+		int r = std::min(l + bSz, rBound);
+		buildBlock(layer, l, r);
+		if (layer == 0) updateBetweenZero(blockIdx);
+		else buildBetween(layer, lBound, rBound, betweenOffs);
+		update(layer + 1, l, r, betweenOffs, x);
+	}
+
+	inline ValueType query(int l, int r, int betweenOffs, int base) {
+		if (l == r) return v[l];
+		if (l + 1 == r) return combine(v[l], v[r]);
+		int layer = onLayer[32 - __builtin_clz((l - base) ^ (r - base))];
+		int bSzLog = (layers[layer] + 1) >> 1;
+		int bCntLog = layers[layer] >> 1;
+		int lBound = (((l - base) >> layers[layer]) << layers[layer]) + base;
+		int lBlock = ((l - lBound) >> bSzLog) + 1;
+		int rBlock = ((r - lBound) >> bSzLog) - 1;
+		ValueType ans = suf[(size_t)layer * width + l];
+		if (lBlock <= rBlock) {
+			ValueType add = (layer == 0)
+			                ? (query(n + lBlock, n + rBlock, (1 << lg) - n, n))
+			                : (between[(size_t)(layer - 1) * betweenWidth + betweenOffs + lBound + (lBlock << bCntLog) + rBlock]);
+			ans = combine(ans, add);
+		}
+		return combine(ans, pref[(size_t)layer * width + r]);
+	}
+
+	/** Combination of [l, r], which must be inside a single block of the layer 0. */
+	inline ValueType queryInBlock(int l, int r) {
+		return query(l, r, 0, 0);
+	}
+
+	/** Combination of the values in the index of the blocks [bl, br] of the layer 0. */
+	inline ValueType queryBlocks(int bl, int br) {
+		return query(n + bl, n + br, (1 << lg) - n, n);
+	}
+
+public:
+	inline ValueType query(int l, int r) {
+		if (l > r) return defaultValueFunc();
+		return query(l, r, 0, 0);
+	}
+
+	inline void update(int x, const ValueType& item) {
+		v[x] = item;
+		update(0, 0, n, 0, x);
+	}
+
+	void build(const std::vector<ValueType>& a) {
+		build(a, 1);
+	}
+
+	void build(const std::vector<ValueType>& a, int threads) {
+		n = (int)a.size();
+		lg = log2Up(n);
+		v = a;
+		onLayer.assign(lg + 1, 0);
+		int tlg = lg;
+		layers.clear();
+		while (tlg > 1) {
+			onLayer[tlg] = (int)layers.size();
+			layers.push_back(tlg);
+			tlg = (tlg + 1) >> 1;
+		}
+		for (int i = lg - 1; i >= 0; i--)
+			onLayer[i] = std::max(onLayer[i], onLayer[i + 1]);
+		int betweenLayers = std::max(0, (int)layers.size() - 1);
+		blockLog = (lg + 1) >> 1;
+		int bSz = 1 << blockLog;
+		indexSz = (n + bSz - 1) >> blockLog;
+		width = n + indexSz;
+		betweenWidth = (1 << lg) + bSz;
+		v.resize(width, defaultValueFunc());
+		pref.assign((size_t)layers.size() * width, defaultValueFunc());
+		suf.assign((size_t)layers.size() * width, defaultValueFunc());
+		between.assign((size_t)betweenLayers * betweenWidth, defaultValueFunc());
+		buildLayerZero(threads);
+	}
+};
+
+/** Sqrt tree to get sum of values in the given interval */
+template<typename ValueType> struct SumCombineSQT { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};
+template<typename ValueType> struct SumDefaultValueSQT { ValueType operator()() { return 0; }};
+template<typename ValueType>
+using FlatSqrtTreeSum = FlatSqrtTree<ValueType, SumCombineSQT<ValueType>, SumDefaultValueSQT<ValueType>>;
+
+/** Sqrt tree to get min value in the given interval */
+template<typename ValueType> struct MinCombineSQT { ValueType operator()(ValueType val1, ValueType val2) { return std::min(val1, val2); }};
+template<typename ValueType> struct MinDefaultValueSQT { ValueType operator()() { return std::numeric_limits<ValueType>::max(); }};
+template<typename ValueType>
+using FlatSqrtTreeMin = FlatSqrtTree<ValueType, MinCombineSQT<ValueType>, MinDefaultValueSQT<ValueType>>;
+
+/** Sqrt tree to get max value in the given interval */
+template<typename ValueType> struct MaxCombineSQT { ValueType operator()(ValueType val1, ValueType val2) { return std::max(val1, val2); }};
+template<typename ValueType> struct MaxDefaultValueSQT { ValueType operator()() { return std::numeric_limits<ValueType>::min(); }};
+template<typename ValueType>
+using FlatSqrtTreeMax = FlatSqrtTree<ValueType, MaxCombineSQT<ValueType>, MaxDefaultValueSQT<ValueType>>;
+
+/**
+ * \brief Defines a class for a Sqrt Tree with lazy range updates (e.g. range assignment and range addition).
+ *        A FlatSqrtTree plus a pending update per block of the layer 0. A range update rebuilds the
+ *        (at most two) blocks partially covered, composes the update into the pending update of the blocks fully covered,
+ *        and rebuilds the index over the blocks. The values stored inside a block never include its pending update, which
+ *        is applied to the part of the answer taken from the block, so the queries stay O(1).
+ *        State: untested.
+ *        Ref: https://cp-algorithms.com/data_structures/sqrt-tree.html (Lazy propagation)
+ *             https://codeforces.com/blog/entry/57046
+ *
+ * \details Build: O(n * log(log(n)))
+ *          Query: O(1)
+ *          Point update, range update: O(sqrt(n) * log(log(n)))
+ *
+ * \tparam ValueType Type of the elements.
+ * \tparam CombineFunc Associative function to combine intervals
+ *         (e.g. struct SumCombine { ValueType operator()(ValueType val1, ValueType val2) { return val1 + val2; }};).
+ * \tparam DefaultValueFunc Function returning the identity of CombineFunc, also returned for an undefined interval (l > r)
+ *         (e.g. struct SumDefaultValue { ValueType operator()() { return 0; }};).
+ * \tparam LazyType Type of the range updates. A value initialized LazyType() must be the identity update.
+ * \tparam ApplyFunc Function applying an update to the value of an interval of the given length
+ *         (e.g. struct SumAddApply { ValueType operator()(ValueType val, ValueType upd, int len) { return val + upd * len; }};).
+ * \tparam ComposeFunc Function returning the update equivalent to applying old and then upd
+ *         (e.g. struct AddCompose { ValueType operator()(ValueType upd, ValueType old) { return upd + old; }};).
+ */
+template<typename ValueType, typename CombineFunc, typename DefaultValueFunc,
+		typename LazyType, typename ApplyFunc, typename ComposeFunc>
+class SqrtTreeRangeUpdateRangeQuery : private FlatSqrtTree<ValueType, CombineFunc, DefaultValueFunc> {
+private:
+	using Tree = FlatSqrtTree<ValueType, CombineFunc, DefaultValueFunc>;
+	using Tree::n;
+	using Tree::indexSz;
+	using Tree::blockLog;
+	using Tree::layers;
+	using Tree::v;
+	using Tree::pref;
+	using Tree::suf;
+	using Tree::combine;
+	using Tree::defaultValueFunc;
+
+	std::vector<LazyType> lazy; // lazy[b]: pending update of the block b of the layer 0
+	std::vector<char> hasLazy;
+	ApplyFunc applyFunc;
+	ComposeFunc compose;
+
+	/** Applies the pending update of the block b of the layer 0 to its elements. */
+	void push(int b) {
+		if (!hasLazy[b]) return;
+		for (int i = b << blockLog; i < std::min(n, (b + 1) << blockLog); i++) v[i] = applyFunc(v[i], lazy[b], 1);
+		lazy[b] = LazyType();
+		hasLazy[b] = false;
+	}
+
+	/** Rebuilds the block b of the layer 0, which must not have a pending update, and its value in the index. */
+	void rebuildBlock(int b) {
+		if (layers.empty()) return;
+		Tree::buildBlockZero(b);
+		v[n + b] = suf[b << blockLog];
+	}
+
+public:
+
+	ValueType query(int l, int r) {
+		if (l > r) return defaultValueFunc();
+		int bl = l >> blockLog, br = r >> blockLog;
+		if (bl == br) {
+			ValueType res = Tree::queryInBlock(l, r);
+			return hasLazy[bl] ? applyFunc(res, lazy[bl], r - l + 1) : res;
+		}
+		// Every block before the last one is full
+		ValueType ans = suf[l];
+		if (hasLazy[bl]) ans = applyFunc(ans, lazy[bl], ((bl + 1) << blockLog) - l);
+		if (bl + 1 < br) ans = combine(ans, Tree::queryBlocks(bl + 1, br - 1));
+		ValueType right = pref[r];
+		if (hasLazy[br]) right = applyFunc(right, lazy[br], r - (br << blockLog) + 1);
+		return combine(ans, right);
+	}
+
+	void update(int x, const ValueType& item) {
+		int b = x >> blockLog;
+		if (!hasLazy[b]) {
+			Tree::update(x, item);
+			return;
+		}
+		// Pushing the pending update changes every element of the block, so the whole block is rebuilt
+		push(b);
+		v[x] = item;
+		rebuildBlock(b);
+		Tree::buildIndex();
+	}
+
+	void update(int l, int r, const LazyType& upd) {
+		if (l > r) return;
+		int bl = l >> blockLog, br = r >> blockLog;
+		for (int b = bl; b <= br; b++) {
+			int start = b << blockLog, end = std::min(n, start + (1 << blockLog));
+			if (l <= start && end - 1 <= r && !layers.empty()) {
+				lazy[b] = hasLazy[b] ? compose(upd, lazy[b]) : upd;
+				hasLazy[b] = true;
+				v[n + b] = applyFunc(v[n + b], upd, end - start);
+			} else {
+				push(b);
+				for (int i = std::max(l, start); i <= std::min(r, end - 1); i++) v[i] = applyFunc(v[i], upd, 1);
+				rebuildBlock(b);
+			}
+		}
+		if (!layers.empty()) Tree::buildIndex();
+	}
+
+	/** Only available if LazyType provides a static add(ValueType) function (e.g. AssignAddLazySQT). */
+	void add(int l, int r, ValueType val) {
+		update(l, r, LazyType::add(val));
+	}
+
+	void build(const std::vector<ValueType>& a) {
+		build(a, 1);
+	}
+
+	void build(const std::vector<ValueType>& a, int threads) {
+		Tree::build(a, threads);
+		lazy.assign(indexSz, LazyType());
+		hasLazy.assign(indexSz, false);
+	}
+};
+
+/**
+ * Range assignment followed by a range addition. Constructing it from a value gives an assignment, so update(l, r, val)
+ * assigns val to the interval and add(l, r, val) adds val to it.
+ */
+template<typename ValueType> struct AssignAddLazySQT {
+	bool assigned;
+	ValueType assignValue, addValue;
+	AssignAddLazySQT() : assigned(false), assignValue(), addValue(0) {}
+	AssignAddLazySQT(ValueType val) : assigned(true), assignValue(val), addValue(0) {}
+	static AssignAddLazySQT add(ValueType val) {
+		AssignAddLazySQT res;
+		res.addValue = val;
+		return res;
+	}
+};
+template<typename ValueType> struct AssignAddComposeSQT {
+	AssignAddLazySQT<ValueType> operator()(const AssignAddLazySQT<ValueType>& upd, AssignAddLazySQT<ValueType> old) {
+		if (upd.assigned) return upd;
+		old.addValue += upd.addValue;
+		return old;
+	}
+};
+
+/** Sqrt tree with range assign/add to get sum of values in the given interval */
+template<typename ValueType> struct SumAssignAddApplySQT {
+	ValueType operator()(ValueType val, const AssignAddLazySQT<ValueType>& upd, int len) {
+		return (upd.assigned ? upd.assignValue * len : val) + upd.addValue * len;
+	}
+};
+template<typename ValueType>
+using SqrtTreeRangeUpdateRangeQuerySum =
+		SqrtTreeRangeUpdateRangeQuery<ValueType, SumCombineSQT<ValueType>, SumDefaultValueSQT<ValueType>,
+				AssignAddLazySQT<ValueType>, SumAssignAddApplySQT<ValueType>, AssignAddComposeSQT<ValueType>>;
+
+/** Applying assign/add updates to a min or max value does not depend on the length of the interval */
+template<typename ValueType> struct MinMaxAssignAddApplySQT {
+	ValueType operator()(ValueType val, const AssignAddLazySQT<ValueType>& upd, int) {
+		return (upd.assigned ? upd.assignValue : val) + upd.addValue;
+	}
+};
+
+/** Sqrt tree with range assign/add to get min value in the given interval */
+template<typename ValueType>
+using SqrtTreeRangeUpdateRangeQueryMin =
+		SqrtTreeRangeUpdateRangeQuery<ValueType, MinCombineSQT<ValueType>, MinDefaultValueSQT<ValueType>,
+				AssignAddLazySQT<ValueType>, MinMaxAssignAddApplySQT<ValueType>, AssignAddComposeSQT<ValueType>>;
+
+/** Sqrt tree with range assign/add to get max value in the given interval */
+template<typename ValueType>
+using SqrtTreeRangeUpdateRangeQueryMax =
+		SqrtTreeRangeUpdateRangeQuery<ValueType, MaxCombineSQT<ValueType>, MaxDefaultValueSQT<ValueType>,
+				AssignAddLazySQT<ValueType>, MinMaxAssignAddApplySQT<ValueType>, AssignAddComposeSQT<ValueType>>;
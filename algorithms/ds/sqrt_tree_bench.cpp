@@ -0,0 +1,66 @@
+#include <bits/stdc++.h>
+
+using namespace std;
+
+#include "sqrt_tree.hpp"
+
+/**
+ * Benchmark of FlatSqrtTreeSum (functor operation, flat storage) against SqrtTree (std::function operation,
+ * vector<vector> storage) with a sum: build time, latency of random range queries and of random point updates.
+ * The answers of both trees are checked to be the same.
+ * Usage: sqrt_tree_bench [n] [queries] [updates]
+ * Build it with optimizations (e.g. g++ -std=c++17 -O2).
+ */
+
+template<typename Func>
+double measure(Func func) {
+	auto start = chrono::steady_clock::now();
+	func();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+struct Result {
+	double build, query, update;
+	unsigned long long checksum; // wraps around, it is only compared
+};
+
+template<typename Tree, typename Build>
+Result run(Build build, const vector<pair<int, int>>& ranges, const vector<pair<int, int>>& updates) {
+	Tree tree;
+	Result res;
+	res.build = measure([&]() { build(tree); });
+	res.checksum = 0;
+	res.query = measure([&]() { for (const auto& [l, r] : ranges) res.checksum += tree.query(l, r); }) / ranges.size();
+	res.update = measure([&]() { for (const auto& [idx, val] : updates) tree.update(idx, val); }) / updates.size();
+	for (size_t i = 0; i < ranges.size(); i += 997) res.checksum += tree.query(ranges[i].first, ranges[i].second);
+	return res;
+}
+
+int main(int argc, char* argv[]) {
+	int n = argc > 1 ? atoi(argv[1]) : 10000000;
+	int queries = argc > 2 ? atoi(argv[2]) : 10000000;
+	int updates = argc > 3 ? atoi(argv[3]) : 100000;
+
+	mt19937 rng(12345);
+	vector<long long> arr(n);
+	for (long long& x : arr) x = rng() % 1000000;
+	vector<pair<int, int>> ranges(queries), points(updates);
+	for (auto& [l, r] : ranges) {
+		l = rng() % n, r = rng() % n;
+		if (l > r) swap(l, r);
+	}
+	for (auto& [idx, val] : points) idx = rng() % n, val = rng() % 1000000;
+
+	// One tree at a time, so both don't need to fit in memory together
+	Result old = run<SqrtTree<long long>>([&](SqrtTree<long long>& tree) {
+		tree.build(arr, [](long long a, long long b) { return a + b; });
+	}, ranges, points);
+	Result flat = run<FlatSqrtTreeSum<long long>>([&](FlatSqrtTreeSum<long long>& tree) { tree.build(arr); }, ranges, points);
+
+	printf("n = %d, %d queries, %d updates\n", n, queries, updates);
+	printf("build:  SqrtTree %.3fs, FlatSqrtTree %.3fs (%.2fx)\n", old.build, flat.build, old.build / flat.build);
+	printf("query:  SqrtTree %.1f ns, FlatSqrtTree %.1f ns (%.2fx)\n", old.query * 1e9, flat.query * 1e9, old.query / flat.query);
+	printf("update: SqrtTree %.1f us, FlatSqrtTree %.1f us (%.2fx)%s\n", old.update * 1e6, flat.update * 1e6, old.update / flat.update,
+	       old.checksum == flat.checksum ? "" : " ANSWERS DIFFER");
+	return 0;
+}